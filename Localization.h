@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <cmath>
 #include <utility>
 
 
@@ -43,7 +44,9 @@ public:
 	/// <param name="other">Docelowa lokalizacja</param>
 	/// <returns>Heurystyka</returns>
 	double heuristic_distance(const Localization& other) const {
-		return std::sqrt(std::pow(x - other.x, 2) + std::pow(y - other.y, 2));
+		const double dx = x - other.x;
+		const double dy = y - other.y;
+		return std::sqrt(dx * dx + dy * dy);
 	}
 	/// <summary>
 	/// Setter lokalizacji
@@ -0,0 +1,229 @@
+﻿#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Localization.h"
+#include "simd/Simd.h"
+
+/// <summary>
+/// Cecha sprawdzająca, czy dane wierzchołka udostępniają lokalizację (metodę get_localization()).
+/// </summary>
+/// <typeparam name="T">Typ danych wierzchołka</typeparam>
+template <typename T, typename = void>
+struct has_localization : std::false_type {};
+
+template <typename T>
+struct has_localization<T, std::void_t<decltype(std::declval<const T&>().get_localization())>> : std::true_type {};
+
+/// <summary>
+/// Klasa przechowująca lokalizacje wielu obiektów w układzie struktury tablic (x[], y[]).
+/// Pozwala na wsadowe, wektorowe (SSE2/AVX2) obliczanie heurystyki dla wielu wierzchołków naraz.
+/// </summary>
+class Localizations
+{
+private:
+	/// <summary>
+	/// Współrzędne x
+	/// </summary>
+	std::vector<double> x;
+	/// <summary>
+	/// Współrzędne y
+	/// </summary>
+	std::vector<double> y;
+
+public:
+	/// <summary>
+	/// Konstruktor domyślny
+	/// </summary>
+	Localizations() {};
+	/// <summary>
+	/// Konstruktor klasy Localizations
+	/// </summary>
+	/// <param name="x">Współrzędne x</param>
+	/// <param name="y">Współrzędne y</param>
+	Localizations(std::vector<double>&& x, std::vector<double>&& y) :
+		x(std::move(x)),
+		y(std::move(y))
+	{}
+
+public:
+	/// <summary>
+	/// Funkcja dodająca lokalizację na koniec tablic
+	/// </summary>
+	/// <param name="localization">Lokalizacja</param>
+	void push_back(const Localization& localization) {
+		x.push_back(localization.x);
+		y.push_back(localization.y);
+	}
+	/// <summary>
+	/// Liczba przechowywanych lokalizacji
+	/// </summary>
+	/// <returns>Liczba lokalizacji</returns>
+	std::size_t size() const { return x.size(); }
+	/// <summary>
+	/// Getter tablicy współrzędnych x
+	/// </summary>
+	/// <returns>Współrzędne x</returns>
+	const std::vector<double>& get_x() const { return x; }
+	/// <summary>
+	/// Getter tablicy współrzędnych y
+	/// </summary>
+	/// <returns>Współrzędne y</returns>
+	const std::vector<double>& get_y() const { return y; }
+	/// <summary>
+	/// Lokalizacja elementu
+	/// </summary>
+	/// <param name="index">Indeks elementu</param>
+	/// <returns>Lokalizacja</returns>
+	Localization at(const std::size_t index) const { return Localization(x[index], y[index]); }
+	/// <summary>
+	/// Rozmiar w pamięci [B]
+	/// </summary>
+	std::size_t memory_bytes() const { return (x.capacity() + y.capacity()) * sizeof(double); }
+
+public:
+	/// <summary>
+	/// Funkcja obliczająca heurystykę dla pojedynczego elementu
+	/// </summary>
+	/// <param name="index">Indeks elementu</param>
+	/// <param name="target">Docelowa lokalizacja</param>
+	/// <returns>Heurystyka</returns>
+	double heuristic_distance(const std::size_t index, const Localization& target) const {
+		const double dx = x[index] - target.x;
+		const double dy = y[index] - target.y;
+		return std::sqrt(dx * dx + dy * dy);
+	}
+	/// <summary>
+	/// Funkcja obliczająca heurystykę dla elementów o podanych indeksach (np. wszystkich sąsiadów wierzchołka).
+	/// </summary>
+	/// <param name="target">Docelowa lokalizacja</param>
+	/// <param name="indices">Indeksy elementów</param>
+	/// <param name="count">Liczba indeksów</param>
+	/// <param name="out">Tablica wynikowa o długości count</param>
+	void heuristic_distances(
+		const Localization& target,
+		const unsigned int* indices,
+		const std::size_t count,
+		double* out
+	) const {
+		std::size_t i = 0;
+#if defined(SIMD_X86_64)
+		if (simd::cpu_supports_avx2()) {
+			i = gather_avx2(target, indices, count, out);
+		}
+		else {
+			i = gather_sse2(target, indices, count, out);
+		}
+#endif
+		for (; i < count; ++i) {
+			out[i] = heuristic_distance(indices[i], target);
+		}
+	}
+	/// <summary>
+	/// Funkcja obliczająca heurystykę dla ciągłego zakresu elementów [first, first + count),
+	/// np. dla wszystkich punktów orientacyjnych zapisanych w osobnym obiekcie Localizations.
+	/// </summary>
+	/// <param name="target">Docelowa lokalizacja</param>
+	/// <param name="first">Indeks pierwszego elementu</param>
+	/// <param name="count">Liczba elementów</param>
+	/// <param name="out">Tablica wynikowa o długości count</param>
+	void heuristic_distances(
+		const Localization& target,
+		const std::size_t first,
+		const std::size_t count,
+		double* out
+	) const {
+		std::size_t i = 0;
+#if defined(SIMD_X86_64)
+		if (simd::cpu_supports_avx2()) {
+			i = range_avx2(target, first, count, out);
+		}
+		else {
+			i = range_sse2(target, first, count, out);
+		}
+#endif
+		for (; i < count; ++i) {
+			out[i] = heuristic_distance(first + i, target);
+		}
+	}
+
+private:
+#if defined(SIMD_X86_64)
+	SIMD_TARGET_AVX2 std::size_t gather_avx2(
+		const Localization& target,
+		const unsigned int* indices,
+		const std::size_t count,
+		double* out
+	) const {
+		const __m256d tx = _mm256_set1_pd(target.x);
+		const __m256d ty = _mm256_set1_pd(target.y);
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i));
+			const __m256d dx = _mm256_sub_pd(simd::gather_pd(x.data(), idx), tx);
+			const __m256d dy = _mm256_sub_pd(simd::gather_pd(y.data(), idx), ty);
+			const __m256d sq = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+			_mm256_storeu_pd(out + i, _mm256_sqrt_pd(sq));
+		}
+		return i;
+	}
+
+	std::size_t gather_sse2(
+		const Localization& target,
+		const unsigned int* indices,
+		const std::size_t count,
+		double* out
+	) const {
+		const __m128d tx = _mm_set1_pd(target.x);
+		const __m128d ty = _mm_set1_pd(target.y);
+		std::size_t i = 0;
+		for (; i + 2 <= count; i += 2) {
+			const __m128d dx = _mm_sub_pd(_mm_set_pd(x[indices[i + 1]], x[indices[i]]), tx);
+			const __m128d dy = _mm_sub_pd(_mm_set_pd(y[indices[i + 1]], y[indices[i]]), ty);
+			const __m128d sq = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+			_mm_storeu_pd(out + i, _mm_sqrt_pd(sq));
+		}
+		return i;
+	}
+
+	SIMD_TARGET_AVX2 std::size_t range_avx2(
+		const Localization& target,
+		const std::size_t first,
+		const std::size_t count,
+		double* out
+	) const {
+		const __m256d tx = _mm256_set1_pd(target.x);
+		const __m256d ty = _mm256_set1_pd(target.y);
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x.data() + first + i), tx);
+			const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y.data() + first + i), ty);
+			const __m256d sq = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+			_mm256_storeu_pd(out + i, _mm256_sqrt_pd(sq));
+		}
+		return i;
+	}
+
+	std::size_t range_sse2(
+		const Localization& target,
+		const std::size_t first,
+		const std::size_t count,
+		double* out
+	) const {
+		const __m128d tx = _mm_set1_pd(target.x);
+		const __m128d ty = _mm_set1_pd(target.y);
+		std::size_t i = 0;
+		for (; i + 2 <= count; i += 2) {
+			const __m128d dx = _mm_sub_pd(_mm_loadu_pd(x.data() + first + i), tx);
+			const __m128d dy = _mm_sub_pd(_mm_loadu_pd(y.data() + first + i), ty);
+			const __m128d sq = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+			_mm_storeu_pd(out + i, _mm_sqrt_pd(sq));
+		}
+		return i;
+	}
+#endif
+};
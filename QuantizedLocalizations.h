@@ -0,0 +1,125 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "Localizations.h"
+
+/// <summary>
+/// Skwantowane lokalizacje: współrzędne zapisane jako liczby całkowite typu Q na siatce o stałym kroku,
+/// rozpiętej na prostokącie ograniczającym wszystkie punkty (dla std::uint16_t - 4 bajty na punkt zamiast 16).
+/// Każdy zdekodowany punkt leży nie dalej niż error_bound() od oryginału. Heurystyka odejmuje
+/// maksymalny błąd, więc pozostaje dolnym ograniczeniem, jeśli było nim ograniczenie na oryginalnych współrzędnych.
+/// </summary>
+/// <typeparam name="Q">Typ całkowity bez znaku przechowujący współrzędną.</typeparam>
+template <typename Q = std::uint16_t>
+class QuantizedLocalizations
+{
+	static_assert(std::is_integral_v<Q> && std::is_unsigned_v<Q>, "quantized coordinates must be unsigned integers");
+
+private:
+	std::vector<Q> x;
+	std::vector<Q> y;
+	double origin_x = 0;
+	double origin_y = 0;
+	/// <summary>
+	/// Krok siatki (wspólny dla obu osi, by nie zniekształcać odległości)
+	/// </summary>
+	double step = 1;
+
+public:
+	/// <summary>
+	/// Konstruktor domyślny
+	/// </summary>
+	QuantizedLocalizations() {}
+	/// <summary>
+	/// Konstruktor kwantujący lokalizacje
+	/// </summary>
+	/// <param name="localizations">Lokalizacje</param>
+	explicit QuantizedLocalizations(const Localizations& localizations) {
+		const std::size_t n = localizations.size();
+		if (n == 0) {
+			return;
+		}
+		const auto& xs = localizations.get_x();
+		const auto& ys = localizations.get_y();
+		const auto [min_x, max_x] = std::minmax_element(xs.begin(), xs.end());
+		const auto [min_y, max_y] = std::minmax_element(ys.begin(), ys.end());
+		origin_x = *min_x;
+		origin_y = *min_y;
+		const double extent = std::max(*max_x - *min_x, *max_y - *min_y);
+		step = extent > 0 ? extent / static_cast<double>(std::numeric_limits<Q>::max()) : 1.0;
+		if (!std::isfinite(step)) {
+			throw std::runtime_error("localizations must be finite to be quantized");
+		}
+
+		x.reserve(n);
+		y.reserve(n);
+		for (std::size_t i = 0; i < n; ++i) {
+			x.push_back(quantize(xs[i] - origin_x));
+			y.push_back(quantize(ys[i] - origin_y));
+		}
+	}
+
+public:
+	/// <summary>
+	/// Liczba przechowywanych lokalizacji
+	/// </summary>
+	std::size_t size() const { return x.size(); }
+	/// <summary>
+	/// Zdekodowana lokalizacja elementu
+	/// </summary>
+	/// <param name="index">Indeks elementu</param>
+	Localization at(const std::size_t index) const {
+		return Localization(origin_x + x[index] * step, origin_y + y[index] * step);
+	}
+	/// <summary>
+	/// Największa odległość zdekodowanego punktu od oryginału (połowa przekątnej oczka siatki)
+	/// </summary>
+	double error_bound() const { return step * std::sqrt(0.5); }
+	/// <summary>
+	/// Funkcja obliczająca heurystykę dla pojedynczego elementu. Cel zwykle pochodzi z tej samej siatki,
+	/// więc odejmowany jest błąd obu punktów.
+	/// </summary>
+	/// <param name="index">Indeks elementu</param>
+	/// <param name="target">Docelowa lokalizacja</param>
+	/// <returns>Heurystyka (dolne ograniczenie odległości między oryginalnymi punktami)</returns>
+	double heuristic_distance(const std::size_t index, const Localization& target) const {
+		const double dx = origin_x + x[index] * step - target.x;
+		const double dy = origin_y + y[index] * step - target.y;
+		return std::max(0.0, std::sqrt(dx * dx + dy * dy) - 2 * error_bound());
+	}
+	/// <summary>
+	/// Funkcja obliczająca heurystykę dla elementów o podanych indeksach (np. wszystkich sąsiadów wierzchołka).
+	/// </summary>
+	/// <param name="target">Docelowa lokalizacja</param>
+	/// <param name="indices">Indeksy elementów</param>
+	/// <param name="count">Liczba indeksów</param>
+	/// <param name="out">Tablica wynikowa o długości count</param>
+	void heuristic_distances(
+		const Localization& target,
+		const unsigned int* indices,
+		const std::size_t count,
+		double* out
+	) const {
+		for (std::size_t i = 0; i < count; ++i) {
+			out[i] = heuristic_distance(indices[i], target);
+		}
+	}
+	/// <summary>
+	/// Rozmiar w pamięci [B]
+	/// </summary>
+	std::size_t memory_bytes() const { return (x.capacity() + y.capacity()) * sizeof(Q); }
+
+private:
+	Q quantize(const double offset) const {
+		const double cell = std::round(offset / step);
+		return static_cast<Q>(std::min(cell, static_cast<double>(std::numeric_limits<Q>::max())));
+	}
+};
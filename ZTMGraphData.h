@@ -1,12 +1,13 @@
 ﻿#pragma once
 
 #include <cmath>
+#include <cstdint>
 #include "Localization.h"
 
 /// <summary>
 /// Enum z typami środków transportu
 /// </summary>
-enum class TransportType {
+enum class TransportType : std::uint8_t {
 	BUS,
 	TRAM,
 	TRAIN
@@ -2,9 +2,14 @@
 
 #include <string>
 #include <fstream>
+#include <ostream>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "ZTMGraphData.h"
 #include "./graph/Graph.h"
+#include "./graph/CompactGraph.h"
+#include "./labels/HubLabels.h"
 /// <summary>
 /// Funkcja zamieniająca numer na typ transportu.
 /// </summary>
@@ -21,12 +26,16 @@ TransportType transport_type_from_int(const unsigned int& value) {
 }
 
 /// <summary>
-/// Funkcja pozwalajaca na wczytanie danych o przystankach z pliku tekstowego.
+/// Funkcja czytająca kolejne wiersze pliku przystanków (id,loc_x,loc_y,transport_type).
+/// Wspólna dla load_stations() i load_compact_network(); odrzuca powtórzone identyfikatory przystanków.
 /// </summary>
-/// <param name="stations_path">Ścieżka do pliku z stacjami</param>
-/// <returns>Wierzchołki grafu</returns>
-Graph<Station>::Vertices load_stations(
-	const std::string& stations_path
+/// <typeparam name="F">Typ funkcji wywoływanej dla przystanku: void(id, localization, transport_type).</typeparam>
+/// <param name="stations_path">Ścieżka do pliku ze stacjami</param>
+/// <param name="on_station">Funkcja wywoływana dla kolejnych przystanków</param>
+template <typename F>
+void read_stations(
+	const std::string& stations_path,
+	F&& on_station
 ) {
 	// line - id,loc_x,loc_y,transport_type
 	std::ifstream file(stations_path);
@@ -34,8 +43,7 @@ Graph<Station>::Vertices load_stations(
 		throw std::runtime_error("cannot open stations file");
 	}
 
-	typename Graph<Station>::Vertices vertices;
-
+	std::unordered_set<unsigned int> ids;
 	while (file.good()) {
 		std::string item;
 
@@ -55,25 +63,28 @@ Graph<Station>::Vertices load_stations(
 			throw std::runtime_error("cannot read #4 item");
 		const unsigned int transport_type_id = std::stoi(item);
 
-		const Localization localization(loc_x, loc_y);
-		const TransportType transport_type = transport_type_from_int(transport_type_id);
-
-		Station station(id, localization, transport_type);
-		VertexSPtr<Station> vertex(new Vertex<Station>(std::move(station)));
-
-		vertices.push_back(std::move(vertex));
+		if (!ids.insert(id).second) {
+			throw std::runtime_error("duplicate station with id " + std::to_string(id));
+		}
+		on_station(id, Localization(loc_x, loc_y), transport_type_from_int(transport_type_id));
 	}
-
-	return vertices;
 }
+
 /// <summary>
-/// Funkcja pozwalajaca na wczytanie danych o połączeniach między przystankami z pliku tekstowego.
+/// Funkcja czytająca kolejne wiersze pliku połączeń (station_from_id,station_to_id,weight) i zamieniająca
+/// identyfikatory przystanków na wierzchołki. Wspólna dla load_routes() i load_compact_network().
+/// Połączenia równoległe (także powtórzone, jak w resources/routes.txt) są dopuszczalne w obu postaciach grafu.
 /// </summary>
-/// <param name="stations_path">Ścieżka do pliku z połączeniami</param>
-/// <returns>Krawędzie grafu</returns>
-Graph<Station>::Edges load_routes(
-	const Graph<Station>::Vertices& vertices,
-	const std::string& routes_path
+/// <typeparam name="V">Typ wierzchołka (np. VertexSPtr&lt;Station&gt; lub VertexIndex).</typeparam>
+/// <typeparam name="F">Typ funkcji wywoływanej dla połączenia: void(from, to, weight).</typeparam>
+/// <param name="routes_path">Ścieżka do pliku z połączeniami</param>
+/// <param name="stations_by_id">Wierzchołki przystanków według identyfikatora</param>
+/// <param name="on_route">Funkcja wywoływana dla kolejnych połączeń</param>
+template <typename V, typename F>
+void read_routes(
+	const std::string& routes_path,
+	const std::unordered_map<unsigned int, V>& stations_by_id,
+	F&& on_route
 ) {
 	// station_from_id,station_to_id,wieght
 	std::ifstream file(routes_path);
@@ -81,28 +92,16 @@ Graph<Station>::Edges load_routes(
 		throw std::runtime_error("cannot open routes file");
 	}
 
-	std::unordered_map<unsigned int, VertexSPtr<Station>> stations_by_id;
-	for (const auto& vertex : vertices) {
-		const unsigned int id = vertex->get_data().get_id();
-		const auto [_, inserted] = stations_by_id.insert(std::make_pair(id, vertex));
-		if (!inserted) {
-			throw std::runtime_error("duplicate station with id " + std::to_string(id));
-		}
-	}
-
-	typename Graph<Station>::Edges edges;
-	
 	while (file.good()) {
 		std::string item;
 
-		if(!std::getline(file, item, ','))
+		if (!std::getline(file, item, ','))
 			throw std::runtime_error("cannot read #1 item");
 		const unsigned int station_from_id = std::stoi(item);
 		const auto station_from_it = stations_by_id.find(station_from_id);
 		if (station_from_it == stations_by_id.cend()) {
 			throw std::runtime_error("station from not found: " + std::to_string(station_from_id));
 		}
-		const VertexSPtr<Station>& station_from = station_from_it->second;
 
 		if (!std::getline(file, item, ','))
 			throw std::runtime_error("cannot read #2 item");
@@ -111,20 +110,60 @@ Graph<Station>::Edges load_routes(
 		if (station_to_it == stations_by_id.cend()) {
 			throw std::runtime_error("station to not found: " + std::to_string(station_to_id));
 		}
-		const VertexSPtr<Station>& station_to = station_to_it->second;
-
-		EdgeSPtr<Station> edge(new Edge<Station>(station_from, station_to));
 
 		if (!std::getline(file, item))
 			throw std::runtime_error("cannot read #3 item");
 		const double weight = std::stod(item);
 
-		const auto & [_, inserted] = edges.insert(std::make_pair(std::move(edge), std::move(weight)));
+		on_route(station_from_it->second, station_to_it->second, weight);
+	}
+}
+
+/// <summary>
+/// Funkcja pozwalajaca na wczytanie danych o przystankach z pliku tekstowego.
+/// </summary>
+/// <param name="stations_path">Ścieżka do pliku z stacjami</param>
+/// <returns>Wierzchołki grafu</returns>
+Graph<Station>::Vertices load_stations(
+	const std::string& stations_path
+) {
+	typename Graph<Station>::Vertices vertices;
+	read_stations(stations_path, [&](const unsigned int id, const Localization& localization, const TransportType transport_type) {
+		Station station(id, localization, transport_type);
+		VertexSPtr<Station> vertex(new Vertex<Station>(std::move(station)));
+
+		vertices.push_back(std::move(vertex));
+	});
+	return vertices;
+}
+/// <summary>
+/// Funkcja pozwalajaca na wczytanie danych o połączeniach między przystankami z pliku tekstowego.
+/// </summary>
+/// <param name="stations_path">Ścieżka do pliku z połączeniami</param>
+/// <returns>Krawędzie grafu</returns>
+Graph<Station>::Edges load_routes(
+	const Graph<Station>::Vertices& vertices,
+	const std::string& routes_path
+) {
+	std::unordered_map<unsigned int, VertexSPtr<Station>> stations_by_id;
+	for (const auto& vertex : vertices) {
+		const unsigned int id = vertex->get_data().get_id();
+		const auto [_, inserted] = stations_by_id.insert(std::make_pair(id, vertex));
 		if (!inserted) {
-			throw std::runtime_error("duplicate route");
+			throw std::runtime_error("duplicate station with id " + std::to_string(id));
 		}
 	}
 
+	typename Graph<Station>::Edges edges;
+	read_routes(routes_path, stations_by_id, [&](const VertexSPtr<Station>& station_from, const VertexSPtr<Station>& station_to, const double weight) {
+		EdgeSPtr<Station> edge(new Edge<Station>(station_from, station_to));
+
+		const auto & [_, inserted] = edges.insert(std::make_pair(std::move(edge), weight));
+		if (!inserted) {
+			throw std::runtime_error("duplicate route");
+		}
+	});
+
 	return edges;
 }
 
@@ -142,3 +181,123 @@ Graph<Station> load_graph(
 	auto edges = load_routes(vertices, routes_path);
 	return Graph<Station>(std::move(vertices), std::move(edges));
 }
+
+/// <summary>
+/// Funkcja wypisująca raport spójności sieci: liczbę silnie spójnych składowych oraz przystanki,
+/// z których nie da się odjechać, do których nie da się dojechać i z których nie da się wrócić do głównej sieci.
+/// </summary>
+/// <param name="graph">Graf przystanków</param>
+/// <param name="out">Strumień wyjściowy</param>
+void print_connectivity_report(
+	const Graph<Station>& graph,
+	std::ostream& out
+) {
+	const ConnectivityReport& report = graph.get_connectivity().report();
+	const auto print_stations = [&](const char* label, const std::vector<VertexIndex>& stations) {
+		out << label << " (" << stations.size() << "):";
+		for (const VertexIndex v : stations) {
+			out << " " << graph.get_vertices()[v]->get_data().get_id();
+		}
+		out << std::endl;
+	};
+
+	out << "strongly connected components: " << report.component_count
+		<< ", largest: " << report.largest_component_size
+		<< " of " << graph.get_vertices().size() << " stations" << std::endl;
+	print_stations("dead-end stations", report.dead_ends);
+	print_stations("unreachable stations", report.unreachable);
+	print_stations("sink stations", report.sinks);
+}
+
+/// <summary>
+/// Funkcja wczytująca indeks etykiet hubów z pliku zapisanego obok plików grafu.
+/// Jeśli plik nie istnieje albo został zbudowany dla innego grafu (np. po zmianie rozkładu),
+/// indeks jest budowany od nowa i zapisywany w tym pliku.
+/// </summary>
+/// <param name="graph">Graf przystanków</param>
+/// <param name="labels_path">Ścieżka do pliku z indeksem</param>
+/// <param name="threads">Liczba wątków budowy (0 - liczba rdzeni)</param>
+/// <returns>Indeks etykiet hubów dla grafu</returns>
+HubLabels load_hub_labels(
+	const Graph<Station>& graph,
+	const std::string& labels_path,
+	const unsigned int threads = 0
+) {
+	{
+		std::ifstream file(labels_path, std::ios::binary);
+		if (file) {
+			try {
+				return HubLabels::load(file, graph.get_adjacency());
+			}
+			catch (const std::runtime_error&) {
+				// Nieaktualny lub uszkodzony plik - indeks zostanie zbudowany ponownie.
+			}
+		}
+	}
+	HubLabels labels(graph.get_adjacency(), threads);
+	std::ofstream file(labels_path, std::ios::binary | std::ios::trunc);
+	if (file) {
+		labels.save(file);
+	}
+	return labels;
+}
+
+/// <summary>
+/// Zwarta sieć przystanków: graf CompactGraph oraz identyfikatory i typy transportu przystanków
+/// zapisane w tablicach indeksowanych numerem wierzchołka.
+/// </summary>
+struct CompactNetwork {
+	CompactGraph<> graph;
+	std::vector<unsigned int> station_ids;
+	std::vector<TransportType> transport_types;
+
+	/// <summary>
+	/// Funkcja zwracająca pamięć zajmowaną przez sieć (graf i dane przystanków)
+	/// </summary>
+	/// <returns>Zestawienie pamięci</returns>
+	MemoryUsage memory_usage() const {
+		MemoryUsage usage = graph.memory_usage();
+		usage.vertex_bytes += station_ids.capacity() * sizeof(unsigned int)
+			+ transport_types.capacity() * sizeof(TransportType);
+		return usage;
+	}
+};
+
+/// <summary>
+/// Funkcja wczytująca stacje i połączenia bezpośrednio do postaci zwartej, bez budowania obiektów
+/// wierzchołków i krawędzi (szczytowe zużycie pamięci to lista krawędzi i jej listy sąsiedztwa).
+/// Format plików jak w load_graph().
+/// </summary>
+/// <param name="stations_path">Ścieżka do pliku ze stacjami</param>
+/// <param name="routes_path">Ścieżka do pliku z połączeniami</param>
+/// <param name="weight_scale">Mnożnik wag przy zapisie stałoprzecinkowym (np. 10 dla dokładności 0.1)</param>
+/// <returns>Zwarta sieć przystanków</returns>
+CompactNetwork load_compact_network(
+	const std::string& stations_path,
+	const std::string& routes_path,
+	const double weight_scale = 1.0
+) {
+	CompactNetwork network;
+	Localizations localizations;
+	std::unordered_map<unsigned int, VertexIndex> indices;
+	read_stations(stations_path, [&](const unsigned int id, const Localization& localization, const TransportType transport_type) {
+		indices.insert(std::make_pair(id, static_cast<VertexIndex>(network.station_ids.size())));
+		network.station_ids.push_back(id);
+		network.transport_types.push_back(transport_type);
+		localizations.push_back(localization);
+	});
+
+	std::vector<std::pair<std::pair<VertexIndex, VertexIndex>, double>> edges;
+	read_routes(routes_path, indices, [&](const VertexIndex from, const VertexIndex to, const double weight) {
+		edges.push_back(std::make_pair(std::make_pair(from, to), weight));
+	});
+
+	network.station_ids.shrink_to_fit();
+	network.transport_types.shrink_to_fit();
+	network.graph = CompactGraph<>(
+		Adjacency<double>(network.station_ids.size(), edges),
+		localizations,
+		weight_scale
+	);
+	return network;
+}
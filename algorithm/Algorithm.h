@@ -1,9 +1,14 @@
 ﻿#pragma once
 
+#include <algorithm>
+#include <limits>
 #include <utility>
 #include <optional>
+#include <vector>
 
 #include "../graph/Graph.h"
+#include "../async/Cancellation.h"
+#include "../async/QueryTask.h"
 
 /// <summary>
 /// Klasa reprezentująca wynik przeszukiwania grafu. 
@@ -51,6 +56,23 @@ public:
 	const Cost& get_cost() const { return cost; }
 };
 
+/// <summary>
+/// Wynik zapytania asynchronicznego. Dla statusu COMPLETED result jest wynikiem ostatecznym (jak z solve()).
+/// Dla zapytania przerwanego result to najlepsza znaleziona dotąd ścieżka do celu (poprawna, ale być może
+/// nie najkrótsza), lub std::nullopt jeśli cel nie został jeszcze osiągnięty.
+/// </summary>
+/// <typeparam name="T">Typ danych wierzchołka grafu</typeparam>
+template <typename T>
+struct AsyncResult {
+	QueryStatus status;
+	std::optional<SolveResult<T>> result;
+
+	/// <summary>
+	/// Czy wynik jest ostateczny (wyszukiwanie nie zostało przerwane)
+	/// </summary>
+	bool is_final() const { return status == QueryStatus::COMPLETED; }
+};
+
 /// <summary>
 /// Interfejs algorytmu do wyszukiwania najkrótszej ścieżki w grafie.
 /// Interfejs pozwalający na wywołanie róznych algorytmów przeszukiania na grafie. Klasa abstrakcyjna.  
@@ -59,12 +81,24 @@ public:
 template <typename T>
 class Algorithm {
 public:
+	/// <summary>
+	/// Destruktor wirtualny - algorytmy są przechowywane i usuwane przez wskaźnik na Algorithm (np. CachedAlgorithm, QueryServer).
+	/// </summary>
+	virtual ~Algorithm() = default;
+
 	/// <summary>
 	/// Metoda zwracająca nazwę agorytmu. 
 	/// </summary>
 	/// <returns>Nazwa algorytmu</returns>
 	virtual const char* name() const = 0;
 
+	/// <summary>
+	/// Czy algorytm zwraca dokładne najkrótsze ścieżki na wagach grafu (double), tak jak algorytm Dijkstry
+	/// przy wagach nieujemnych. Pozwala CachedAlgorithm odpowiadać z drzew najkrótszych ścieżek.
+	/// </summary>
+	/// <returns>true, jeśli wyniki są zgodne z algorytmem Dijkstry</returns>
+	virtual bool is_dijkstra_equivalent() const { return false; }
+
 	/// <summary>
 	/// Funkcja pozwalajaca znaleźć najkrótszą ścieżkę w grafie. 
 	/// </summary>
@@ -77,4 +111,102 @@ public:
 		const VertexSPtr<T>& start,
 		const VertexSPtr<T>& end
 	) const = 0;
+
+	using Task = QueryTask<AsyncResult<T>>;
+
+	/// <summary>
+	/// Funkcja pozwalająca znaleźć najkrótszą ścieżkę asynchronicznie. Zwraca korutynę, która wstrzymuje się
+	/// co limits.slice kroków wyszukiwania i wtedy sprawdza anulowanie i termin.
+	/// Domyślna implementacja sprawdza ograniczenia tylko przed wywołaniem blokującego solve().
+	/// Graf i obiekt algorytmu muszą istnieć aż do zakończenia korutyny.
+	/// </summary>
+	/// <param name="graph">Graf, w którym będzie szukana ścieżka.</param>
+	/// <param name="start">Wierzchołek początkowy.</param>
+	/// <param name="end">Wierzchołek końcowy.</param>
+	/// <param name="limits">Token anulowania, termin i długość fragmentu wyszukiwania.</param>
+	/// <returns>Korutyna zwracająca AsyncResult.</returns>
+	virtual Task solve_async(
+		const Graph<T>& graph,
+		VertexSPtr<T> start,
+		VertexSPtr<T> end,
+		QueryLimits limits = QueryLimits()
+	) const {
+		if (const auto reason = limits.stop_reason()) {
+			co_return AsyncResult<T>{ *reason, std::nullopt };
+		}
+		co_return AsyncResult<T>{ QueryStatus::COMPLETED, solve(graph, start, end) };
+	}
+
+protected:
+	/// <summary>
+	/// Funkcja odtwarzająca ścieżkę na podstawie tablicy poprzedników indeksowanej wierzchołkami grafu.
+	/// </summary>
+	/// <param name="graph">Graf, w którym szukano ścieżki.</param>
+	/// <param name="previous">Poprzednicy wierzchołków (NO_VERTEX, jeśli brak).</param>
+	/// <param name="start">Indeks wierzchołka początkowego.</param>
+	/// <param name="end">Indeks wierzchołka końcowego.</param>
+	/// <param name="cost">Całkowity koszt ścieżki.</param>
+	/// <returns>SolveResult, lub std::nullopt jeśli łańcuch poprzedników nie prowadzi do wierzchołka początkowego.</returns>
+	static std::optional<SolveResult<T>> make_result(
+		const Graph<T>& graph,
+		const std::vector<VertexIndex>& previous,
+		const VertexIndex start,
+		const VertexIndex end,
+		typename SolveResult<T>::Cost cost
+	) {
+		const auto& vertices = graph.get_vertices();
+
+		typename SolveResult<T>::Path path;
+		path.push_back(vertices[end]);
+
+		VertexIndex current = end;
+		while (current != start) {
+			const VertexIndex prev = previous[current];
+			if (prev == NO_VERTEX || path.size() > vertices.size()) {
+				return std::nullopt;
+			}
+			path.push_back(vertices[prev]);
+			current = prev;
+		}
+		std::reverse(path.begin(), path.end());
+
+		return SolveResult<T>(
+			std::move(path),
+			std::move(cost)
+			);
+	}
+	/// <summary>
+	/// Funkcja odtwarzająca ścieżkę jak make_result(), ale liczącą koszt od nowa z wag grafu
+	/// (dla krawędzi równoległych brana jest najmniejsza waga). Używana, gdy odległości wyznaczone
+	/// przez wyszukiwanie nie są dokładnym kosztem ścieżki (wagi zaokrąglone, wynik częściowy).
+	/// </summary>
+	/// <param name="graph">Graf, w którym szukano ścieżki.</param>
+	/// <param name="previous">Poprzednicy wierzchołków (NO_VERTEX, jeśli brak).</param>
+	/// <param name="start">Indeks wierzchołka początkowego.</param>
+	/// <param name="end">Indeks wierzchołka końcowego.</param>
+	/// <returns>SolveResult, lub std::nullopt jeśli łańcuch poprzedników nie prowadzi do wierzchołka początkowego.</returns>
+	static std::optional<SolveResult<T>> make_result(
+		const Graph<T>& graph,
+		const std::vector<VertexIndex>& previous,
+		const VertexIndex start,
+		const VertexIndex end
+	) {
+		const auto& adjacency = graph.get_adjacency();
+		typename SolveResult<T>::Cost cost = 0.0;
+		std::size_t hops = 0;
+		for (VertexIndex v = end; v != start; v = previous[v]) {
+			const VertexIndex u = previous[v];
+			if (u == NO_VERTEX || ++hops > adjacency.vertex_count()) {
+				return std::nullopt;
+			}
+			double weight = std::numeric_limits<double>::infinity();
+			for (std::size_t e = adjacency.begin(u); e < adjacency.end(u); ++e) {
+				if (adjacency.get_targets()[e] == v) {
+					weight = std::min(weight, adjacency.get_weights()[e]);
+				}
+			}
+			cost += weight;
+		}
+		return make_result(graph, previous, start, end, cost);
+	}
 };
\ No newline at end of file
@@ -2,9 +2,12 @@
 
 
 #include "Algorithm.h"
+#include "../simd/Relaxation.h"
 
+#include <algorithm>
 #include <limits>
 #include <optional>
+#include <vector>
 
 /// <summary>
 /// Klasa reprezentująca algorytm BellmanaForda.
@@ -24,6 +27,10 @@ public:
 		return "BellmanFord";
 	};
 	/// <summary>
+	/// Przy wagach nieujemnych wyniki są dokładnymi najkrótszymi ścieżkami, jak w algorytmie Dijkstry.
+	/// </summary>
+	bool is_dijkstra_equivalent() const override { return true; }
+	/// <summary>
 	/// Funkcja szukająca najkrótszej ścieżki w grafie zgodnie z algorytmem BellmanaForda. 
 	/// </summary>
 	/// <param name="graph">Graf, w którym będzie szukana ścieżka.</param>
@@ -35,48 +42,72 @@ public:
 		const VertexSPtr<T>& start,
 		const VertexSPtr<T>& end
 	) const override {
-		std::unordered_map<VertexSPtr<T>, double> d;
-		d.insert(std::make_pair(start, 0.0));
-		for (auto const& vertex : graph.get_vertices()) {
-			d.insert(std::make_pair(vertex, std::numeric_limits<double>::max()));
+		QueryLimits limits;
+		limits.slice = std::numeric_limits<std::size_t>::max();
+		return solve_async(graph, start, end, std::move(limits)).wait().result;
+	}
+	/// <summary>
+	/// Funkcja szukająca najkrótszej ścieżki asynchronicznie: punkt wstrzymania co limits.slice wierzchołków
+	/// przetworzonych w rundach relaksacji. Po przerwaniu zwracana jest bieżąca ścieżka z drzewa poprzedników
+	/// (jeśli cel został już osiągnięty) wraz z jej rzeczywistym kosztem.
+	/// </summary>
+	/// <param name="graph">Graf, w którym będzie szukana ścieżka.</param>
+	/// <param name="start">Wierzchołek początkowy.</param>
+	/// <param name="end">Wierzchołek końcowy.</param>
+	/// <param name="limits">Token anulowania, termin i długość fragmentu wyszukiwania.</param>
+	/// <returns>Korutyna zwracająca AsyncResult.</returns>
+	typename Algorithm<T>::Task solve_async(
+		const Graph<T>& graph,
+		VertexSPtr<T> start,
+		VertexSPtr<T> end,
+		QueryLimits limits = QueryLimits()
+	) const override {
+		const auto& adjacency = graph.get_adjacency();
+		const auto& targets = adjacency.get_targets();
+		const auto& weights = adjacency.get_weights();
+		const std::size_t n = graph.get_vertices().size();
+		const VertexIndex s = graph.index_of(start);
+		const VertexIndex t = graph.index_of(end);
+		if (!graph.get_connectivity().reachable(s, t)) {
+			co_return AsyncResult<T>{ QueryStatus::COMPLETED, std::nullopt };
+		}
+		if (const auto reason = limits.stop_reason()) {
+			co_return AsyncResult<T>{ *reason, std::nullopt };
 		}
 
-		std::unordered_map<VertexSPtr<T>, VertexSPtr<T>> p;
+		std::vector<double> d(n, std::numeric_limits<double>::infinity());
+		d[s] = 0.0;
 
-		for (unsigned int v = 0; v < graph.get_vertices().size() - 1; ++v) {
-			for (auto const& [edge, weight] : graph.get_edges()) {
-				const auto& d_from = d.at(edge->get_from());
-				const auto& d_to = d.at(edge->get_to());
+		std::vector<VertexIndex> p(n, NO_VERTEX);
 
-				if (d_from + weight < d_to) {
-					d.insert_or_assign(edge->get_to(), d_from + weight);
-					p.insert_or_assign(edge->get_to(), edge->get_from());
+		const std::size_t slice = std::max<std::size_t>(1, limits.slice);
+		std::size_t budget = slice;
+		for (std::size_t v = 0; v + 1 < n; ++v) {
+			bool changed = false;
+			for (VertexIndex u = 0; u < n; ++u) {
+				if (budget-- == 0) {
+					if (const auto reason = limits.stop_reason()) {
+						// W trakcie rund d[t] może być większe od kosztu ścieżki z drzewa poprzedników
+						// (poprzednicy mogli się od tego czasu poprawić), więc koszt liczony jest od nowa.
+						co_return AsyncResult<T>{ *reason, Algorithm<T>::make_result(graph, p, s, t) };
+					}
+					co_await std::suspend_always{};
+					budget = slice - 1;
+				}
+				if (d[u] == std::numeric_limits<double>::infinity()) {
+					continue;
 				}
+				const std::size_t first = adjacency.begin(u);
+				changed |= simd::relax_edges(
+					u, targets.data() + first, weights.data() + first, adjacency.degree(u), d.data(), p.data()
+				);
 			}
-		}
-
-		typename SolveResult<T>::Path path;
-		path.push_back(end);
-
-		VertexSPtr<T> path_temp = end;
-		while (path_temp != start) {
-			const auto& path_prev_it = p.find(path_temp);
-			if (path_prev_it == p.cend()) {
-				return std::nullopt;
+			// Brak zmian w całej rundzie oznacza, że odległości są już ostateczne.
+			if (!changed) {
+				break;
 			}
-			const auto& path_prev = path_prev_it->second;
-
-			path.push_back(path_prev);
-
-			path_temp = path_prev;
 		}
-		std::reverse(path.begin(), path.end());
-
-		typename SolveResult<T>::Cost cost = d.at(end);
 
-		return SolveResult<T>(
-			std::move(path),
-			std::move(cost)
-			);
+		co_return AsyncResult<T>{ QueryStatus::COMPLETED, Algorithm<T>::make_result(graph, p, s, t, d[t]) };
 	}
 };
\ No newline at end of file
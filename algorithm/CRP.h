@@ -0,0 +1,130 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "Algorithm.h"
+#include "../overlay/OverlayRouter.h"
+
+/// <summary>
+/// Klasa reprezentująca routing na wielopoziomowych nakładkach (CRP).
+/// Podział grafu wyznaczany jest raz w konstruktorze. Jeśli wagi grafu zmieniły się od ostatniej
+/// kustomizacji (inna wersja grafu), solve() przed wyszukiwaniem przelicza kliki równolegle;
+/// gdy znane są zmienione krawędzie, szybciej jest wywołać customize() tylko dla nich.
+/// </summary>
+/// <typeparam name="T">Typ wierzchołka grafu (z lokalizacją).</typeparam>
+template <typename T>
+class CRP :
+	public Algorithm<T>
+{
+private:
+	/// <summary>
+	/// Graf, dla którego wyznaczono podział
+	/// </summary>
+	const Graph<T>& graph;
+	/// <summary>
+	/// Silnik routingu
+	/// </summary>
+	const std::unique_ptr<OverlayRouter> router;
+	/// <summary>
+	/// Wersja grafu, dla której wykonano ostatnią kustomizację
+	/// </summary>
+	mutable std::uint64_t customized_version;
+	mutable std::shared_mutex mutex;
+
+public:
+	/// <summary>
+	/// Konstruktor klasy CRP
+	/// </summary>
+	/// <param name="graph">Graf (musi istnieć przez cały czas życia obiektu)</param>
+	/// <param name="cell_sizes">Maksymalne rozmiary komórek kolejnych poziomów (rosnąco)</param>
+	/// <param name="threads">Liczba wątków kustomizacji (0 - liczba rdzeni)</param>
+	CRP(
+		const Graph<T>& graph,
+		const std::vector<std::size_t>& cell_sizes = { 64, 1024, 16384 },
+		const unsigned int threads = 0
+	) :
+		graph(graph),
+		router(std::make_unique<OverlayRouter>(graph.get_adjacency(), graph.get_localizations(), cell_sizes, threads)),
+		customized_version(graph.get_version())
+	{}
+
+public:
+	/// <summary>
+	/// Funkcja zwracajaca nazwę algorytmu.
+	/// </summary>
+	/// <returns>Nazwa algorytmu.</returns>
+	const char* name() const override {
+		return "CRP";
+	};
+	/// <summary>
+	/// Funkcja przeliczająca kliki komórek zawierających krawędzie o zmienionych wagach.
+	/// </summary>
+	/// <param name="changed">Krawędzie, których wagi zostały zmienione przez Graph::set_weight</param>
+	void customize(const std::vector<EdgeSPtr<T>>& changed) {
+		std::vector<VertexIndex> vertices;
+		for (const auto& edge : changed) {
+			vertices.push_back(graph.index_of(edge->get_from()));
+			vertices.push_back(graph.index_of(edge->get_to()));
+		}
+		std::unique_lock<std::shared_mutex> lock(mutex);
+		router->customize(vertices);
+		customized_version = graph.get_version();
+	}
+	/// <summary>
+	/// Funkcja szukająca najkrótszej ścieżki w grafie po nakładkach.
+	/// </summary>
+	/// <param name="graph">Graf, w którym będzie szukana ścieżka (ten sam, co w konstruktorze).</param>
+	/// <param name="start">Wierzchołek początkowy.</param>
+	/// <param name="end">Wierzchołek końcowy.</param>
+	/// <returns>Zwraca znalezioną ścieżkę i całkowity koszt, w przypadku braku istnienia ścieżki std::nullopt.</returns>
+	std::optional<SolveResult<T>> solve(
+		const Graph<T>& graph,
+		const VertexSPtr<T>& start,
+		const VertexSPtr<T>& end
+	) const override {
+		if (&graph != &this->graph) {
+			throw std::runtime_error("CRP was prepared for a different graph");
+		}
+
+		const VertexIndex s = graph.index_of(start);
+		const VertexIndex t = graph.index_of(end);
+		if (!graph.get_connectivity().reachable(s, t)) {
+			return std::nullopt;
+		}
+
+		std::shared_lock<std::shared_mutex> lock(mutex);
+		if (customized_version != graph.get_version()) {
+			lock.unlock();
+			{
+				std::unique_lock<std::shared_mutex> exclusive(mutex);
+				if (customized_version != graph.get_version()) {
+					router->customize();
+					customized_version = graph.get_version();
+				}
+			}
+			lock.lock();
+		}
+
+		const auto path = router->query(s, t);
+		if (!path) {
+			return std::nullopt;
+		}
+
+		typename SolveResult<T>::Path vertices;
+		for (const VertexIndex v : path->vertices) {
+			vertices.push_back(graph.get_vertices()[v]);
+		}
+		typename SolveResult<T>::Cost cost = path->cost;
+		return SolveResult<T>(std::move(vertices), std::move(cost));
+	}
+	/// <summary>
+	/// Getter statystyk silnika (czas podziału, kustomizacji i zapytań)
+	/// </summary>
+	/// <returns>Statystyki</returns>
+	OverlayStats get_stats() const { return router->get_stats(); }
+};
@@ -0,0 +1,130 @@
+﻿#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "Algorithm.h"
+#include "SearchKernel.h"
+#include "../cache/QueryCache.h"
+
+/// <summary>
+/// Klasa opakowująca dowolny algorytm pamięcią podręczną zapytań (QueryCache).
+/// Wynik jest wyszukiwany kolejno: w pamięci wyników punkt-punkt, w drzewie najkrótszych ścieżek ze źródła,
+/// a dopiero potem liczony przez opakowany algorytm. Dla źródeł, z których padło co najmniej
+/// QueryCacheConfig::hot_source_threshold chybień, wyznaczane jest całe drzewo najkrótszych ścieżek (Dijkstra),
+/// więc kolejne zapytania z tego źródła do dowolnego celu są obsługiwane bez przeszukiwania grafu.
+/// Drzewa używane są tylko dla algorytmów zgodnych z algorytmem Dijkstry (Algorithm::is_dijkstra_equivalent())
+/// na grafach bez ujemnych wag; inne algorytmy (np. A* z niedopuszczalną heurystyką, wagi zaokrąglone)
+/// korzystają wyłącznie z pamięci wyników punkt-punkt.
+/// Klasa nie nadpisuje solve_async(): domyślna implementacja sprawdza anulowanie i termin tylko przed
+/// blokującym solve(), więc opakowany algorytm traci możliwość wstrzymania i przerwania w trakcie wyszukiwania.
+/// </summary>
+/// <typeparam name="T">Typ wierzchołków grafu.</typeparam>
+template <typename T>
+class CachedAlgorithm :
+	public Algorithm<T>
+{
+private:
+	/// <summary>
+	/// Opakowany algorytm
+	/// </summary>
+	const std::unique_ptr<Algorithm<T>> algorithm;
+	/// <summary>
+	/// Pamięć podręczna (może być współdzielona przez wiele algorytmów i wątków)
+	/// </summary>
+	const std::shared_ptr<QueryCache<T>> cache;
+	/// <summary>
+	/// Skrót opcji algorytmu, które wpływają na wynik
+	/// </summary>
+	const std::uint64_t options;
+
+public:
+	/// <summary>
+	/// Konstruktor klasy CachedAlgorithm
+	/// </summary>
+	/// <param name="algorithm">Opakowany algorytm</param>
+	/// <param name="cache">Pamięć podręczna</param>
+	/// <param name="options">Skrót opcji algorytmu (np. skali wag), dołączany do klucza</param>
+	CachedAlgorithm(
+		std::unique_ptr<Algorithm<T>> algorithm,
+		std::shared_ptr<QueryCache<T>> cache,
+		const std::uint64_t options = 0
+	) :
+		algorithm(std::move(algorithm)),
+		cache(std::move(cache)),
+		options(options)
+	{}
+
+public:
+	/// <summary>
+	/// Funkcja zwracajaca nazwę algorytmu.
+	/// </summary>
+	/// <returns>Nazwa opakowanego algorytmu.</returns>
+	const char* name() const override {
+		return algorithm->name();
+	}
+	/// <summary>
+	/// Zgodność z algorytmem Dijkstry jak w opakowanym algorytmie
+	/// </summary>
+	bool is_dijkstra_equivalent() const override {
+		return algorithm->is_dijkstra_equivalent();
+	}
+	/// <summary>
+	/// Funkcja szukająca najkrótszej ścieżki z użyciem pamięci podręcznej.
+	/// </summary>
+	/// <param name="graph">Graf, w którym będzie szukana ścieżka.</param>
+	/// <param name="start">Wierzchołek początkowy.</param>
+	/// <param name="end">Wierzchołek końcowy.</param>
+	/// <returns>Zwraca znalezioną ścieżkę i całkowity koszt, w przypadku braku istnienia ścieżki std::nullopt.</returns>
+	std::optional<SolveResult<T>> solve(
+		const Graph<T>& graph,
+		const VertexSPtr<T>& start,
+		const VertexSPtr<T>& end
+	) const override {
+		const VertexIndex s = graph.index_of(start);
+		const VertexIndex t = graph.index_of(end);
+		if (!graph.get_connectivity().reachable(s, t)) {
+			return std::nullopt;
+		}
+		const QueryKey key{ algorithm->name(), s, t, options, graph.get_version() };
+
+		if (const auto cached = cache->find(key)) {
+			return *cached;
+		}
+
+		if (algorithm->is_dijkstra_equivalent() && !graph.has_negative_weights()) {
+			auto tree = cache->find_tree(graph, key);
+			if (!tree && cache->record_miss(graph, key)) {
+				tree = build_tree(graph, s);
+				cache->insert_tree(graph, key, tree);
+			}
+			if (tree) {
+				if (tree->dist[t] == policy::WeightTraits<double>::infinity()) {
+					return std::nullopt;
+				}
+				return Algorithm<T>::make_result(graph, tree->previous, s, t, tree->dist[t]);
+			}
+		}
+
+		auto result = algorithm->solve(graph, start, end);
+		cache->insert(key, result);
+		return result;
+	}
+
+private:
+	/// <summary>
+	/// Funkcja wyznaczająca drzewo najkrótszych ścieżek ze źródła
+	/// </summary>
+	/// <param name="graph">Graf</param>
+	/// <param name="source">Źródło</param>
+	/// <returns>Drzewo najkrótszych ścieżek</returns>
+	static std::shared_ptr<const ShortestPathTree> build_tree(const Graph<T>& graph, const VertexIndex source) {
+		DijkstraKernel<double, policy::ExhaustAll> kernel;
+		kernel.run(graph.get_adjacency(), source, NO_VERTEX, policy::NoHeuristic());
+
+		auto tree = std::make_shared<ShortestPathTree>();
+		tree->dist = kernel.get_distances();
+		tree->previous = kernel.get_previous();
+		return tree;
+	}
+};
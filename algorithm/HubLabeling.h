@@ -0,0 +1,176 @@
+﻿#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "Algorithm.h"
+#include "../labels/HubLabels.h"
+
+/// <summary>
+/// Klasa reprezentująca zapytania o najkrótsze ścieżki z indeksu etykiet hubów.
+/// Zapytanie nie przeszukuje grafu: odległość to przecięcie dwóch etykiet, a ścieżka odtwarzana jest
+/// ze wskaźników rodziców. Gdy potrzebny jest tylko koszt (np. wycena przejazdu), distance() nie buduje ścieżki.
+/// Etykiety zależą od wag, więc po zmianie wersji grafu indeks jest przebudowywany przy następnym zapytaniu.
+/// </summary>
+/// <typeparam name="T">Typ wierzchołka grafu.</typeparam>
+template <typename T>
+class HubLabeling :
+	public Algorithm<T>
+{
+private:
+	/// <summary>
+	/// Graf, dla którego zbudowano indeks
+	/// </summary>
+	const Graph<T>& graph;
+	const unsigned int threads;
+	const bool with_paths;
+	mutable HubLabels labels;
+	/// <summary>
+	/// Wersja grafu, dla której zbudowano indeks
+	/// </summary>
+	mutable std::uint64_t labeled_version;
+	mutable std::shared_mutex mutex;
+
+public:
+	/// <summary>
+	/// Konstruktor budujący indeks
+	/// </summary>
+	/// <param name="graph">Graf (musi istnieć przez cały czas życia obiektu)</param>
+	/// <param name="threads">Liczba wątków budowy (0 - liczba rdzeni)</param>
+	/// <param name="with_paths">Czy indeks ma pozwalać na odtwarzanie ścieżek</param>
+	HubLabeling(const Graph<T>& graph, const unsigned int threads = 0, const bool with_paths = true) :
+		graph(graph),
+		threads(threads),
+		with_paths(with_paths),
+		labels(graph.get_adjacency(), threads, with_paths),
+		labeled_version(graph.get_version())
+	{}
+	/// <summary>
+	/// Konstruktor korzystający z gotowego indeksu (np. wczytanego z pliku)
+	/// </summary>
+	/// <param name="graph">Graf (musi istnieć przez cały czas życia obiektu)</param>
+	/// <param name="labels">Indeks zbudowany dla tego grafu</param>
+	/// <param name="threads">Liczba wątków przy ewentualnej przebudowie (0 - liczba rdzeni)</param>
+	HubLabeling(const Graph<T>& graph, HubLabels labels, const unsigned int threads = 0) :
+		graph(graph),
+		threads(threads),
+		with_paths(labels.has_paths()),
+		labels(std::move(labels)),
+		labeled_version(graph.get_version())
+	{
+		if (!this->labels.matches(graph.get_adjacency())) {
+			throw std::runtime_error("hub labels were built for a different graph");
+		}
+	}
+
+public:
+	/// <summary>
+	/// Funkcja zwracajaca nazwę algorytmu.
+	/// </summary>
+	/// <returns>Nazwa algorytmu.</returns>
+	const char* name() const override {
+		return "HubLabeling";
+	};
+	/// <summary>
+	/// Funkcja szukająca najkrótszej ścieżki w grafie na podstawie etykiet hubów.
+	/// </summary>
+	/// <param name="graph">Graf, w którym będzie szukana ścieżka (ten sam, co w konstruktorze).</param>
+	/// <param name="start">Wierzchołek początkowy.</param>
+	/// <param name="end">Wierzchołek końcowy.</param>
+	/// <returns>Zwraca znalezioną ścieżkę i całkowity koszt, w przypadku braku istnienia ścieżki std::nullopt.</returns>
+	std::optional<SolveResult<T>> solve(
+		const Graph<T>& graph,
+		const VertexSPtr<T>& start,
+		const VertexSPtr<T>& end
+	) const override {
+		if (!with_paths) {
+			throw std::runtime_error("hub labels were built without paths; use distance()");
+		}
+		std::shared_lock<std::shared_mutex> lock = current(graph);
+		const VertexIndex s = graph.index_of(start);
+		const VertexIndex t = graph.index_of(end);
+		const double cost = labels.distance(s, t);
+		if (std::isinf(cost)) {
+			return std::nullopt;
+		}
+
+		typename SolveResult<T>::Path vertices;
+		for (const VertexIndex v : labels.path(s, t)) {
+			vertices.push_back(graph.get_vertices()[v]);
+		}
+		typename SolveResult<T>::Cost total = cost;
+		return SolveResult<T>(std::move(vertices), std::move(total));
+	}
+	/// <summary>
+	/// Funkcja zwracająca tylko koszt najkrótszej ścieżki.
+	/// </summary>
+	/// <param name="start">Wierzchołek początkowy.</param>
+	/// <param name="end">Wierzchołek końcowy.</param>
+	/// <returns>Koszt, w przypadku braku istnienia ścieżki std::nullopt.</returns>
+	std::optional<double> distance(const VertexSPtr<T>& start, const VertexSPtr<T>& end) const {
+		std::shared_lock<std::shared_mutex> lock = current(graph);
+		const double cost = labels.distance(graph.index_of(start), graph.index_of(end));
+		if (std::isinf(cost)) {
+			return std::nullopt;
+		}
+		return cost;
+	}
+	/// <summary>
+	/// Funkcja wywołująca f(labels) na indeksie aktualnym dla bieżącej wersji grafu (pod blokadą do odczytu),
+	/// np. dla zapytań wielu do wielu.
+	/// </summary>
+	/// <param name="graph">Graf (ten sam, co w konstruktorze)</param>
+	/// <param name="f">Funkcja przyjmująca const HubLabels&amp;</param>
+	/// <returns>Wynik funkcji f</returns>
+	template <typename F>
+	decltype(auto) with_labels(const Graph<T>& graph, F&& f) const {
+		std::shared_lock<std::shared_mutex> lock = current(graph);
+		return f(static_cast<const HubLabels&>(labels));
+	}
+	/// <summary>
+	/// Getter statystyk indeksu (rozmiar etykiet, czas budowy)
+	/// </summary>
+	/// <returns>Statystyki</returns>
+	HubLabelStats get_stats() const {
+		std::shared_lock<std::shared_mutex> lock(mutex);
+		return labels.get_stats();
+	}
+	/// <summary>
+	/// Funkcja zapisująca indeks (np. obok plików grafu)
+	/// </summary>
+	/// <param name="out">Strumień binarny</param>
+	void save(std::ostream& out) const {
+		std::shared_lock<std::shared_mutex> lock = current(graph);
+		labels.save(out);
+	}
+
+private:
+	/// <summary>
+	/// Funkcja zwracająca blokadę do odczytu indeksu aktualnego dla bieżącej wersji grafu
+	/// (przebudowuje indeks, jeśli wagi grafu zmieniły się od ostatniej budowy).
+	/// </summary>
+	std::shared_lock<std::shared_mutex> current(const Graph<T>& graph) const {
+		if (&graph != &this->graph) {
+			throw std::runtime_error("hub labels were built for a different graph");
+		}
+		std::shared_lock<std::shared_mutex> lock(mutex);
+		if (labeled_version != graph.get_version()) {
+			lock.unlock();
+			{
+				std::unique_lock<std::shared_mutex> exclusive(mutex);
+				if (labeled_version != graph.get_version()) {
+					labels = HubLabels(graph.get_adjacency(), threads, with_paths);
+					labeled_version = graph.get_version();
+				}
+			}
+			lock.lock();
+		}
+		return lock;
+	}
+};
@@ -0,0 +1,164 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+
+#include "Algorithm.h"
+#include "SearchKernel.h"
+
+/// <summary>
+/// Cienki adapter udostępniający jądro wyszukiwania (SearchKernel) przez wirtualny interfejs Algorithm.
+/// Dla wag typu innego niż Graph::Weight listy sąsiedztwa są konwertowane raz na wersję grafu
+/// (wraz z największą wagą dla kolejki kubełkowej) i współdzielone przez kolejne zapytania.
+/// </summary>
+/// <typeparam name="T">Typ wierzchołków grafu.</typeparam>
+/// <typeparam name="Kernel">Typ jądra wyszukiwania.</typeparam>
+template <typename T, typename Kernel>
+class KernelAlgorithm :
+	public Algorithm<T>
+{
+public:
+	using Weight = typename Kernel::Weight;
+
+private:
+	/// <summary>
+	/// Mnożnik wag przy konwersji do typu Weight
+	/// </summary>
+	const double weight_scale;
+	/// <summary>
+	/// Listy sąsiedztwa przygotowane dla jednej wersji grafu
+	/// </summary>
+	struct Prepared {
+		std::uint64_t graph_version = 0;
+		std::optional<Adjacency<Weight>> converted;
+		const Adjacency<Weight>* adjacency = nullptr;
+		Weight max_weight = Weight(0);
+	};
+	/// <summary>
+	/// Listy przygotowane dla ostatnio odpytywanej wersji grafu (wersje są unikalne w obrębie procesu).
+	/// Zapytania w toku trzymają własną kopię wskaźnika, więc zmiana wersji ich nie unieważnia.
+	/// </summary>
+	mutable std::mutex prepared_mutex;
+	mutable std::shared_ptr<const Prepared> prepared;
+
+public:
+	/// <summary>
+	/// Konstruktor klasy KernelAlgorithm.
+	/// </summary>
+	/// <param name="weight_scale">Mnożnik wag przy konwersji do typu Weight (np. 10 dla wag całkowitych z dokładnością do 0.1).</param>
+	KernelAlgorithm(const double weight_scale = 1.0) : weight_scale(weight_scale) {}
+
+public:
+	/// <summary>
+	/// Funkcja szukająca najkrótszej ścieżki w grafie przy pomocy jądra Kernel.
+	/// </summary>
+	/// <param name="graph">Graf, w którym będzie szukana ścieżka.</param>
+	/// <param name="start">Wierzchołek początkowy.</param>
+	/// <param name="end">Wierzchołek końcowy.</param>
+	/// <returns>Zwraca znalezioną ścieżkę i całkowity koszt, w przypadku braku istnienia ścieżki std::nullopt.</returns>
+	std::optional<SolveResult<T>> solve(
+		const Graph<T>& graph,
+		const VertexSPtr<T>& start,
+		const VertexSPtr<T>& end
+	) const override {
+		QueryLimits limits;
+		limits.slice = std::numeric_limits<std::size_t>::max();
+		return solve_async(graph, start, end, std::move(limits)).wait().result;
+	}
+	/// <summary>
+	/// Funkcja szukająca najkrótszej ścieżki asynchronicznie: jądro wykonuje limits.slice zdjęć z kolejki
+	/// między punktami wstrzymania. Po przerwaniu zwracana jest najlepsza znaleziona dotąd ścieżka do celu.
+	/// </summary>
+	/// <param name="graph">Graf, w którym będzie szukana ścieżka.</param>
+	/// <param name="start">Wierzchołek początkowy.</param>
+	/// <param name="end">Wierzchołek końcowy.</param>
+	/// <param name="limits">Token anulowania, termin i długość fragmentu wyszukiwania.</param>
+	/// <returns>Korutyna zwracająca AsyncResult.</returns>
+	typename Algorithm<T>::Task solve_async(
+		const Graph<T>& graph,
+		VertexSPtr<T> start,
+		VertexSPtr<T> end,
+		QueryLimits limits = QueryLimits()
+	) const override {
+		const VertexIndex s = graph.index_of(start);
+		const VertexIndex t = graph.index_of(end);
+		if (!graph.get_connectivity().reachable(s, t)) {
+			co_return AsyncResult<T>{ QueryStatus::COMPLETED, std::nullopt };
+		}
+		const typename Kernel::HeuristicPolicy heuristic(graph, t, weight_scale);
+
+		const auto lists = prepare(graph);
+		const Adjacency<Weight>* adjacency = lists->adjacency;
+
+		Kernel kernel;
+		kernel.begin(*adjacency, s, t, heuristic, lists->max_weight);
+		while (true) {
+			if (const auto reason = limits.stop_reason()) {
+				co_return AsyncResult<T>{ *reason, result(graph, kernel, s, t, false) };
+			}
+			if (kernel.resume(*adjacency, std::max<std::size_t>(1, limits.slice))) {
+				break;
+			}
+			co_await std::suspend_always{};
+		}
+		co_return AsyncResult<T>{ QueryStatus::COMPLETED, result(graph, kernel, s, t, true) };
+	}
+
+private:
+	/// <summary>
+	/// Funkcja zwracająca listy sąsiedztwa w typie Weight dla bieżącej wersji grafu,
+	/// konwertując je (i wyznaczając największą wagę) tylko przy pierwszym zapytaniu na tej wersji.
+	/// </summary>
+	std::shared_ptr<const Prepared> prepare(const Graph<T>& graph) const {
+		const std::uint64_t version = graph.get_version();
+		std::lock_guard<std::mutex> lock(prepared_mutex);
+		if (!prepared || prepared->graph_version != version) {
+			auto next = std::make_shared<Prepared>();
+			next->graph_version = version;
+			if constexpr (std::is_same_v<Weight, typename Graph<T>::Weight>) {
+				next->adjacency = &graph.get_adjacency();
+			}
+			else {
+				next->converted.emplace(graph.get_adjacency().template cast<Weight>(weight_scale));
+				next->adjacency = &*next->converted;
+			}
+			if constexpr (Kernel::QueuePolicy::needs_max_weight) {
+				next->max_weight = policy::max_weight(*next->adjacency);
+			}
+			prepared = std::move(next);
+		}
+		return prepared;
+	}
+	/// <summary>
+	/// Funkcja tworząca wynik ze stanu jądra (także w trakcie wyszukiwania - wtedy jest to najlepsza
+	/// znaleziona dotąd ścieżka)
+	/// </summary>
+	/// <param name="finished">Czy wyszukiwanie się zakończyło</param>
+	std::optional<SolveResult<T>> result(
+		const Graph<T>& graph,
+		const Kernel& kernel,
+		const VertexIndex s,
+		const VertexIndex t,
+		const bool finished
+	) const {
+		if (!kernel.reached(t)) {
+			return std::nullopt;
+		}
+		if constexpr (std::is_same_v<Weight, typename Graph<T>::Weight>) {
+			if (finished) {
+				return Algorithm<T>::make_result(graph, kernel.get_previous(), s, t, kernel.get_distances()[t]);
+			}
+		}
+		// Koszt liczony jest od nowa z wag grafu wzdłuż poprzedników: odległości jądra są sumą zaokrąglonych wag,
+		// a przerwane wyszukiwanie (np. A* z ponownym otwieraniem wierzchołków) mogło już poprawić poprzednika
+		// wierzchołka t bez poprawienia odległości t, więc dist[t] i łańcuch poprzedników mogą się nie zgadzać.
+		return Algorithm<T>::make_result(graph, kernel.get_previous(), s, t);
+	}
+};
@@ -0,0 +1,454 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Algorithm.h"
+#include "HubLabeling.h"
+
+/// <summary>
+/// Gęsta macierz kosztów: wiersz i to i-te źródło, kolumna j to j-ty cel.
+/// Pary bez ścieżki mają koszt CostMatrix::UNREACHABLE (+inf).
+/// </summary>
+/// <typeparam name="C">Typ kosztu.</typeparam>
+template <typename C = double>
+class CostMatrix
+{
+public:
+	static constexpr C UNREACHABLE = std::numeric_limits<C>::infinity();
+
+private:
+	std::size_t row_count = 0;
+	std::size_t column_count = 0;
+	std::vector<C> costs;
+
+public:
+	/// <summary>
+	/// Konstruktor domyślny (macierz pusta)
+	/// </summary>
+	CostMatrix() {}
+	/// <summary>
+	/// Konstruktor tworzący macierz wypełnioną wartością UNREACHABLE
+	/// </summary>
+	/// <param name="rows">Liczba wierszy (źródeł)</param>
+	/// <param name="columns">Liczba kolumn (celów)</param>
+	CostMatrix(const std::size_t rows, const std::size_t columns) :
+		row_count(rows),
+		column_count(columns),
+		costs(rows * columns, UNREACHABLE)
+	{}
+
+public:
+	std::size_t rows() const { return row_count; }
+	std::size_t columns() const { return column_count; }
+	/// <summary>
+	/// Koszt z i-tego źródła do j-tego celu
+	/// </summary>
+	const C& at(const std::size_t i, const std::size_t j) const { return costs[i * column_count + j]; }
+	/// <summary>
+	/// Wiersz i-tego źródła (columns() kolejnych kosztów)
+	/// </summary>
+	C* row(const std::size_t i) { return costs.data() + i * column_count; }
+	const C* row(const std::size_t i) const { return costs.data() + i * column_count; }
+	/// <summary>
+	/// Czy j-ty cel jest osiągalny z i-tego źródła
+	/// </summary>
+	bool reachable(const std::size_t i, const std::size_t j) const { return at(i, j) != UNREACHABLE; }
+	/// <summary>
+	/// Getter wszystkich kosztów (wierszami)
+	/// </summary>
+	const std::vector<C>& get_costs() const { return costs; }
+};
+
+/// <summary>
+/// Kubełki celów: dla każdego wierzchołka (lub huba) wpisy (kolumna celu, odległość od wierzchołka do celu)
+/// zebrane z przeszukań wstecz. Przeszukanie w przód, które osiągnęło wierzchołek v w odległości d,
+/// poprawia koszty do celów z kubełka v o d + odległość z wpisu.
+/// </summary>
+class TargetBuckets
+{
+public:
+	/// <summary>
+	/// Przestrzeń przeszukania wstecz jednego celu: pary (wierzchołek, odległość do celu)
+	/// </summary>
+	using SearchSpace = std::vector<std::pair<VertexIndex, double>>;
+
+private:
+	struct Entry {
+		std::uint32_t column;
+		double distance;
+	};
+
+	std::vector<std::size_t> offsets;
+	std::vector<Entry> entries;
+
+public:
+	/// <summary>
+	/// Konstruktor grupujący przestrzenie przeszukań po wierzchołkach
+	/// </summary>
+	/// <param name="vertex_count">Liczba wierzchołków (lub hubów)</param>
+	/// <param name="spaces">Przestrzenie przeszukań wstecz kolejnych celów</param>
+	TargetBuckets(const std::size_t vertex_count, const std::vector<SearchSpace>& spaces) :
+		offsets(vertex_count + 1, 0)
+	{
+		for (const SearchSpace& space : spaces) {
+			for (const auto& [v, _] : space) {
+				++offsets[v + 1];
+			}
+		}
+		for (std::size_t v = 0; v < vertex_count; ++v) {
+			offsets[v + 1] += offsets[v];
+		}
+		entries.resize(offsets.back());
+		std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+		for (std::size_t column = 0; column < spaces.size(); ++column) {
+			for (const auto& [v, distance] : spaces[column]) {
+				entries[next[v]++] = Entry{ static_cast<std::uint32_t>(column), distance };
+			}
+		}
+	}
+
+public:
+	/// <summary>
+	/// Czy kubełek wierzchołka jest pusty
+	/// </summary>
+	bool empty(const VertexIndex v) const { return offsets[v] == offsets[v + 1]; }
+	/// <summary>
+	/// Funkcja poprawiająca koszty wiersza wpisami z kubełka wierzchołka
+	/// </summary>
+	/// <param name="v">Wierzchołek osiągnięty przez przeszukanie w przód</param>
+	/// <param name="distance">Odległość od źródła do v</param>
+	/// <param name="row">Koszty do kolejnych celów</param>
+	/// <param name="improved">Wywoływana dla kolumn, których koszt się zmniejszył</param>
+	template <typename F>
+	void scan(const VertexIndex v, const double distance, double* row, F&& improved) const {
+		for (std::size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+			const double cost = distance + entries[i].distance;
+			if (cost < row[entries[i].column]) {
+				row[entries[i].column] = cost;
+				improved(entries[i].column);
+			}
+		}
+	}
+	/// <summary>
+	/// Łączna liczba wpisów
+	/// </summary>
+	std::size_t entry_count() const { return entries.size(); }
+};
+
+/// <summary>
+/// Wyznaczanie macierzy kosztów wielu do wielu metodą kubełków: jedno przeszukanie wstecz na cel zapisuje
+/// odległości w kubełkach odwiedzonych wierzchołków, a jedno przeszukanie w przód na źródło przegląda kubełki
+/// osiąganych wierzchołków. Przeszukania (wstecz i w przód) wykonywane są równolegle.
+/// Działa na zwykłym grafie (listy sąsiedztwa) oraz na indeksie etykiet hubów, gdzie przestrzenią
+/// przeszukania wstecz celu jest jego etykieta wstecz, a przeszukania w przód - etykieta w przód źródła.
+/// </summary>
+class BucketManyToMany
+{
+private:
+	static constexpr double INF = std::numeric_limits<double>::infinity();
+
+	using Entry = std::pair<double, VertexIndex>;
+	using Heap = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+
+	/// <summary>
+	/// Obszar roboczy przeszukania (zerowany tylko w odwiedzonych wierzchołkach)
+	/// </summary>
+	struct Workspace {
+		std::vector<double> dist;
+		std::vector<VertexIndex> touched;
+		Heap heap;
+
+		void reset(const std::size_t n) {
+			if (dist.size() != n) {
+				dist.assign(n, INF);
+				touched.clear();
+			}
+			for (const VertexIndex v : touched) {
+				dist[v] = INF;
+			}
+			touched.clear();
+			heap = Heap();
+		}
+		bool relax(const VertexIndex v, const double d) {
+			if (d >= dist[v]) {
+				return false;
+			}
+			if (dist[v] == INF) {
+				touched.push_back(v);
+			}
+			dist[v] = d;
+			heap.push(std::make_pair(d, v));
+			return true;
+		}
+	};
+
+public:
+	/// <summary>
+	/// Funkcja wyznaczająca macierz kosztów na zwykłym grafie.
+	/// Przeszukanie wstecz celu t zatrzymuje się po ustaleniu bucket_limit wierzchołków (kula o promieniu r_t).
+	/// Przeszukanie w przód przegląda kubełki przy każdej poprawie odległości i kończy się, gdy dla każdego
+	/// celu odległość z kolejki plus r_t nie jest mniejsza od najlepszego kosztu - każda krótsza ścieżka
+	/// musiałaby wejść do kuli z wierzchołka spoza niej, jeszcze nieustalonego.
+	/// </summary>
+	/// <typeparam name="W">Typ wagi.</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa grafu</param>
+	/// <param name="sources">Źródła (wiersze)</param>
+	/// <param name="targets">Cele (kolumny)</param>
+	/// <param name="threads">Liczba wątków (0 - liczba rdzeni)</param>
+	/// <param name="bucket_limit">Rozmiar kuli wstecz (0 - tak, by kubełki miały łącznie ok. 4 wpisy na wierzchołek grafu)</param>
+	/// <returns>Macierz kosztów</returns>
+	template <typename W>
+	static CostMatrix<double> costs(
+		const Adjacency<W>& adjacency,
+		const std::vector<VertexIndex>& sources,
+		const std::vector<VertexIndex>& targets,
+		const unsigned int threads = 0,
+		std::size_t bucket_limit = 0
+	) {
+		const std::size_t n = adjacency.vertex_count();
+		check(n, sources);
+		check(n, targets);
+		CostMatrix<double> matrix(sources.size(), targets.size());
+		if (sources.empty() || targets.empty()) {
+			return matrix;
+		}
+		if (bucket_limit == 0) {
+			bucket_limit = std::max<std::size_t>(1, 4 * n / targets.size());
+		}
+
+		const Adjacency<W> reversed = adjacency.reversed();
+		std::vector<TargetBuckets::SearchSpace> spaces(targets.size());
+		// Promień kuli wstecz celu: wierzchołki bliżej celu niż radius[j] na pewno są w kubełkach.
+		std::vector<double> radius(targets.size(), INF);
+		parallel_for(targets.size(), threads, [&](const std::size_t j, Workspace& workspace) {
+			workspace.reset(n);
+			workspace.relax(targets[j], 0.0);
+			while (!workspace.heap.empty()) {
+				const auto [d, v] = workspace.heap.top();
+				if (d > workspace.dist[v]) {
+					workspace.heap.pop();
+					continue;
+				}
+				if (spaces[j].size() == bucket_limit) {
+					radius[j] = d;
+					break;
+				}
+				workspace.heap.pop();
+				spaces[j].push_back(std::make_pair(v, d));
+				for (std::size_t e = reversed.begin(v); e < reversed.end(v); ++e) {
+					workspace.relax(reversed.get_targets()[e], d + static_cast<double>(reversed.get_weights()[e]));
+				}
+			}
+		});
+		const TargetBuckets buckets(n, spaces);
+		spaces = {};
+
+		parallel_for(sources.size(), threads, [&](const std::size_t i, Workspace& workspace) {
+			double* row = matrix.row(i);
+			// Przeszukanie kończy się, gdy klucz osiągnie max po celach (row[j] - radius[j]). Maksimum tylko maleje
+			// wraz z poprawą kosztów, więc nieaktualna wartość jest bezpieczna - odświeżana jest co targets.size() kroków.
+			const auto slack = [&](const std::size_t j) { return radius[j] == INF ? -INF : row[j] - radius[j]; };
+			double bound = INF;
+			bool stale = true;
+			std::size_t since_refresh = targets.size();
+			const auto visit = [&](const VertexIndex v, const double d) {
+				buckets.scan(v, d, row, [&](std::size_t) { stale = true; });
+			};
+
+			workspace.reset(n);
+			workspace.relax(sources[i], 0.0);
+			visit(sources[i], 0.0);
+			while (!workspace.heap.empty()) {
+				const auto [d, u] = workspace.heap.top();
+				workspace.heap.pop();
+				if (d > workspace.dist[u]) {
+					continue;
+				}
+				if (stale && ++since_refresh >= targets.size()) {
+					bound = -INF;
+					for (std::size_t j = 0; j < targets.size(); ++j) {
+						bound = std::max(bound, slack(j));
+					}
+					stale = false;
+					since_refresh = 0;
+				}
+				if (d >= bound) {
+					break;
+				}
+				for (std::size_t e = adjacency.begin(u); e < adjacency.end(u); ++e) {
+					const VertexIndex v = adjacency.get_targets()[e];
+					const double alt = d + static_cast<double>(adjacency.get_weights()[e]);
+					if (workspace.relax(v, alt) && !buckets.empty(v)) {
+						visit(v, alt);
+					}
+				}
+			}
+		});
+		return matrix;
+	}
+	/// <summary>
+	/// Funkcja wyznaczająca macierz kosztów na indeksie etykiet hubów (wynik dokładny, bez przeszukiwania grafu).
+	/// </summary>
+	/// <param name="labels">Indeks etykiet hubów</param>
+	/// <param name="sources">Źródła (wiersze)</param>
+	/// <param name="targets">Cele (kolumny)</param>
+	/// <param name="threads">Liczba wątków (0 - liczba rdzeni)</param>
+	/// <returns>Macierz kosztów</returns>
+	static CostMatrix<double> costs(
+		const HubLabels& labels,
+		const std::vector<VertexIndex>& sources,
+		const std::vector<VertexIndex>& targets,
+		const unsigned int threads = 0
+	) {
+		const std::size_t n = labels.vertex_count();
+		check(n, sources);
+		check(n, targets);
+		CostMatrix<double> matrix(sources.size(), targets.size());
+		if (sources.empty() || targets.empty()) {
+			return matrix;
+		}
+
+		std::vector<TargetBuckets::SearchSpace> spaces(targets.size());
+		for (std::size_t j = 0; j < targets.size(); ++j) {
+			const HubLabels::LabelView label = labels.backward_label(targets[j]);
+			spaces[j].reserve(label.size);
+			for (std::size_t k = 0; k < label.size; ++k) {
+				spaces[j].push_back(std::make_pair(label.hubs[k], label.distances[k]));
+			}
+		}
+		const TargetBuckets buckets(n, spaces);
+		spaces = {};
+
+		parallel_for(sources.size(), threads, [&](const std::size_t i, Workspace&) {
+			const HubLabels::LabelView label = labels.forward_label(sources[i]);
+			for (std::size_t k = 0; k < label.size; ++k) {
+				buckets.scan(label.hubs[k], label.distances[k], matrix.row(i), [](std::size_t) {});
+			}
+		});
+		return matrix;
+	}
+
+private:
+	static void check(const std::size_t n, const std::vector<VertexIndex>& vertices) {
+		for (const VertexIndex v : vertices) {
+			if (v >= n) {
+				throw std::runtime_error("vertex index out of range");
+			}
+		}
+	}
+	/// <summary>
+	/// Funkcja wykonująca f(i, workspace) dla i z [0, count) na puli wątków (każdy wątek ma własny obszar roboczy)
+	/// </summary>
+	template <typename F>
+	static void parallel_for(const std::size_t count, unsigned int threads, F&& f) {
+		if (threads == 0) {
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		std::atomic<std::size_t> next{ 0 };
+		const auto worker = [&]() {
+			Workspace workspace;
+			for (std::size_t i = next++; i < count; i = next++) {
+				f(i, workspace);
+			}
+		};
+		std::vector<std::thread> pool;
+		const unsigned int workers = static_cast<unsigned int>(std::min<std::size_t>(threads, count));
+		for (unsigned int t = 1; t < workers; ++t) {
+			pool.emplace_back(worker);
+		}
+		worker();
+		for (auto& thread : pool) {
+			thread.join();
+		}
+	}
+};
+
+/// <summary>
+/// Klasa wyznaczająca koszty najkrótszych ścieżek z wielu źródeł do wielu celów (np. przydział pojazdów do zleceń)
+/// metodą kubełków (BucketManyToMany), zamiast osobnego wywołania solve() dla każdej pary.
+/// Jeśli podano indeks etykiet hubów, kubełki budowane są z etykiet; w przeciwnym razie z przeszukań grafu.
+/// </summary>
+/// <typeparam name="T">Typ wierzchołka grafu.</typeparam>
+template <typename T>
+class ManyToMany
+{
+public:
+	using Cost = typename SolveResult<T>::Cost;
+	using Matrix = CostMatrix<Cost>;
+
+private:
+	const HubLabeling<T>* index = nullptr;
+	const unsigned int threads;
+	const std::size_t bucket_limit;
+
+public:
+	/// <summary>
+	/// Konstruktor dla zwykłego grafu
+	/// </summary>
+	/// <param name="threads">Liczba wątków (0 - liczba rdzeni)</param>
+	/// <param name="bucket_limit">Rozmiar kuli przeszukania wstecz (0 - dobierany automatycznie)</param>
+	explicit ManyToMany(const unsigned int threads = 0, const std::size_t bucket_limit = 0) :
+		threads(threads),
+		bucket_limit(bucket_limit)
+	{}
+	/// <summary>
+	/// Konstruktor korzystający z indeksu etykiet hubów
+	/// </summary>
+	/// <param name="index">Indeks (musi istnieć przez cały czas życia obiektu)</param>
+	/// <param name="threads">Liczba wątków (0 - liczba rdzeni)</param>
+	explicit ManyToMany(const HubLabeling<T>& index, const unsigned int threads = 0) :
+		index(&index),
+		threads(threads),
+		bucket_limit(0)
+	{}
+
+public:
+	/// <summary>
+	/// Funkcja zwracajaca nazwę algorytmu.
+	/// </summary>
+	/// <returns>Nazwa algorytmu.</returns>
+	const char* name() const {
+		return index ? "ManyToMany (HubLabeling)" : "ManyToMany";
+	}
+	/// <summary>
+	/// Funkcja wyznaczająca macierz kosztów najkrótszych ścieżek.
+	/// </summary>
+	/// <param name="graph">Graf</param>
+	/// <param name="sources">Wierzchołki początkowe (wiersze macierzy)</param>
+	/// <param name="targets">Wierzchołki końcowe (kolumny macierzy)</param>
+	/// <returns>Macierz kosztów (Matrix::UNREACHABLE dla par bez ścieżki)</returns>
+	Matrix solve(
+		const Graph<T>& graph,
+		const std::vector<VertexSPtr<T>>& sources,
+		const std::vector<VertexSPtr<T>>& targets
+	) const {
+		const std::vector<VertexIndex> rows = indices(graph, sources);
+		const std::vector<VertexIndex> columns = indices(graph, targets);
+		if (index) {
+			return index->with_labels(graph, [&](const HubLabels& labels) {
+				return BucketManyToMany::costs(labels, rows, columns, threads);
+			});
+		}
+		return BucketManyToMany::costs(graph.get_adjacency(), rows, columns, threads, bucket_limit);
+	}
+
+private:
+	static std::vector<VertexIndex> indices(const Graph<T>& graph, const std::vector<VertexSPtr<T>>& vertices) {
+		std::vector<VertexIndex> result;
+		result.reserve(vertices.size());
+		for (const auto& vertex : vertices) {
+			result.push_back(graph.index_of(vertex));
+		}
+		return result;
+	}
+};
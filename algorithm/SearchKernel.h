@@ -0,0 +1,282 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "SearchPolicies.h"
+
+/// <summary>
+/// Jądro wyszukiwania najkrótszych ścieżek typu Dijkstra/A* sparametryzowane politykami.
+/// Typ wagi, kolejka, heurystyka, zbiór odwiedzonych oraz warunek zatrzymania są parametrami szablonu,
+/// więc dla każdej konfiguracji kompilator generuje osobną pętlę bez wywołań wirtualnych.
+/// Obiekt jądra przechowuje tablice robocze i może być używany wielokrotnie (nie jest współdzielony między wątkami).
+/// </summary>
+/// <typeparam name="W">Typ wagi krawędzi (np. double, float, std::uint32_t).</typeparam>
+/// <typeparam name="Queue">Kolejka priorytetowa (policy::BinaryHeapQueue, policy::BucketQueue).</typeparam>
+/// <typeparam name="Heuristic">Heurystyka (policy::NoHeuristic, policy::EuclideanHeuristic, ...).</typeparam>
+/// <typeparam name="Visited">Zbiór odwiedzonych (policy::NoVisited, policy::ByteVisited, policy::BitsetVisited).</typeparam>
+/// <typeparam name="Stop">Warunek zatrzymania (policy::StopAtTarget, policy::ExhaustAll).</typeparam>
+template <
+	typename W,
+	template <typename> class Queue,
+	typename Heuristic,
+	typename Visited,
+	typename Stop
+>
+class SearchKernel
+{
+	static_assert(!(Queue<W>::requires_monotone_keys && Heuristic::enabled),
+		"monotone queues (e.g. BucketQueue) cannot be combined with a heuristic");
+
+public:
+	using Weight = W;
+	using HeuristicPolicy = Heuristic;
+	using QueuePolicy = Queue<W>;
+	using Traits = policy::WeightTraits<W>;
+
+private:
+	/// <summary>
+	/// Odległości od wierzchołka początkowego
+	/// </summary>
+	std::vector<W> dist;
+	/// <summary>
+	/// Klucze kolejki (odległość + heurystyka), używane tylko gdy heurystyka jest włączona
+	/// </summary>
+	std::vector<W> keys;
+	/// <summary>
+	/// Poprzednicy wierzchołków na najkrótszych ścieżkach
+	/// </summary>
+	std::vector<VertexIndex> previous;
+	/// <summary>
+	/// Bufor na heurystykę sąsiadów bieżącego wierzchołka
+	/// </summary>
+	std::vector<double> neighbours_h;
+	Queue<W> queue;
+	Visited visited;
+	Stop stop_rule;
+	/// <summary>
+	/// Stan wyszukiwania wykonywanego fragmentami (begin/resume)
+	/// </summary>
+	VertexIndex target = NO_VERTEX;
+	const Heuristic* active_heuristic = nullptr;
+	bool finished = true;
+
+public:
+	/// <summary>
+	/// Funkcja uruchamiająca wyszukiwanie.
+	/// </summary>
+	/// <typeparam name="A">Typ list sąsiedztwa (np. Adjacency&lt;W&gt;).</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa grafu.</param>
+	/// <param name="start">Wierzchołek początkowy.</param>
+	/// <param name="end">Wierzchołek końcowy (ignorowany przez policy::ExhaustAll).</param>
+	/// <param name="heuristic">Heurystyka względem wierzchołka końcowego.</param>
+	template <typename A>
+	void run(
+		const A& adjacency,
+		const VertexIndex start,
+		const VertexIndex end,
+		const Heuristic& heuristic
+	) {
+		begin(adjacency, start, end, heuristic);
+		resume(adjacency, std::numeric_limits<std::size_t>::max());
+	}
+	/// <summary>
+	/// Funkcja uruchamiająca wyszukiwanie ze znaną największą wagą krawędzi (bez przeglądania wag).
+	/// </summary>
+	/// <typeparam name="A">Typ list sąsiedztwa (np. Adjacency&lt;W&gt;).</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa grafu.</param>
+	/// <param name="start">Wierzchołek początkowy.</param>
+	/// <param name="end">Wierzchołek końcowy (ignorowany przez policy::ExhaustAll).</param>
+	/// <param name="heuristic">Heurystyka względem wierzchołka końcowego.</param>
+	/// <param name="max_weight">Największa waga krawędzi w adjacency (policy::max_weight).</param>
+	template <typename A>
+	void run(
+		const A& adjacency,
+		const VertexIndex start,
+		const VertexIndex end,
+		const Heuristic& heuristic,
+		const W max_weight
+	) {
+		begin(adjacency, start, end, heuristic, max_weight);
+		resume(adjacency, std::numeric_limits<std::size_t>::max());
+	}
+	/// <summary>
+	/// Funkcja przygotowująca wyszukiwanie wykonywane fragmentami przez resume()
+	/// (heurystyka musi istnieć aż do zakończenia wyszukiwania).
+	/// </summary>
+	/// <typeparam name="A">Typ list sąsiedztwa (np. Adjacency&lt;W&gt;).</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa grafu.</param>
+	/// <param name="start">Wierzchołek początkowy.</param>
+	/// <param name="end">Wierzchołek końcowy (ignorowany przez policy::ExhaustAll).</param>
+	/// <param name="heuristic">Heurystyka względem wierzchołka końcowego.</param>
+	template <typename A>
+	void begin(
+		const A& adjacency,
+		const VertexIndex start,
+		const VertexIndex end,
+		const Heuristic& heuristic
+	) {
+		if constexpr (QueuePolicy::needs_max_weight) {
+			begin(adjacency, start, end, heuristic, policy::max_weight(adjacency));
+		}
+		else {
+			begin(adjacency, start, end, heuristic, W(0));
+		}
+	}
+	/// <summary>
+	/// Funkcja przygotowująca wyszukiwanie fragmentami ze znaną największą wagą krawędzi.
+	/// </summary>
+	/// <typeparam name="A">Typ list sąsiedztwa (np. Adjacency&lt;W&gt;).</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa grafu.</param>
+	/// <param name="start">Wierzchołek początkowy.</param>
+	/// <param name="end">Wierzchołek końcowy (ignorowany przez policy::ExhaustAll).</param>
+	/// <param name="heuristic">Heurystyka względem wierzchołka końcowego.</param>
+	/// <param name="max_weight">Największa waga krawędzi w adjacency (policy::max_weight).</param>
+	template <typename A>
+	void begin(
+		const A& adjacency,
+		const VertexIndex start,
+		const VertexIndex end,
+		const Heuristic& heuristic,
+		const W max_weight
+	) {
+		static_assert(std::is_same_v<typename A::Weight, W>, "adjacency weight type must match the kernel");
+
+		const std::size_t n = adjacency.vertex_count();
+		dist.assign(n, Traits::infinity());
+		previous.assign(n, NO_VERTEX);
+		visited.reset(n);
+		queue.reset(max_weight);
+		target = end;
+		active_heuristic = &heuristic;
+		finished = false;
+
+		dist[start] = W(0);
+		if constexpr (Heuristic::enabled) {
+			keys.assign(n, Traits::infinity());
+			double h = 0.0;
+			heuristic.evaluate(&start, 1, &h);
+			keys[start] = static_cast<W>(h);
+			queue.push(keys[start], start);
+		}
+		else {
+			queue.push(W(0), start);
+		}
+	}
+	/// <summary>
+	/// Funkcja kontynuująca wyszukiwanie rozpoczęte przez begin() o co najwyżej steps zdjęć z kolejki.
+	/// Między wywołaniami get_distances()[v] jest długością najlepszej znalezionej dotąd ścieżki do v.
+	/// </summary>
+	/// <typeparam name="A">Typ list sąsiedztwa (te same, co w begin()).</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa grafu.</param>
+	/// <param name="steps">Maksymalna liczba zdjęć z kolejki.</param>
+	/// <returns>true, jeśli wyszukiwanie się zakończyło</returns>
+	template <typename A>
+	bool resume(const A& adjacency, std::size_t steps) {
+		typename A::Scratch scratch;
+		for (; !finished && steps > 0; --steps) {
+			if (queue.empty()) {
+				finished = true;
+				break;
+			}
+			const auto [key, u] = queue.pop();
+			if constexpr (Heuristic::enabled) {
+				if (key > keys[u]) {
+					continue;
+				}
+			}
+			else {
+				if (key > dist[u]) {
+					continue;
+				}
+			}
+			if (visited.test_and_set(u)) {
+				continue;
+			}
+
+			if (stop_rule.stop(u, target)) {
+				finished = true;
+				break;
+			}
+
+			const auto row = adjacency.row(u, scratch);
+			if constexpr (Heuristic::enabled) {
+				neighbours_h.resize(row.count);
+				active_heuristic->evaluate(row.targets, row.count, neighbours_h.data());
+			}
+
+			const W dist_u = dist[u];
+			for (std::size_t i = 0; i < row.count; ++i) {
+				const VertexIndex v = row.targets[i];
+				if (visited.contains(v)) {
+					continue;
+				}
+
+				const W alt = Traits::add(dist_u, row.weights[i]);
+				if (alt < dist[v]) {
+					dist[v] = alt;
+					previous[v] = u;
+					if constexpr (Heuristic::enabled) {
+						keys[v] = Traits::add(alt, static_cast<W>(neighbours_h[i]));
+						queue.push(keys[v], v);
+					}
+					else {
+						queue.push(alt, v);
+					}
+				}
+			}
+		}
+		return finished;
+	}
+
+public:
+	/// <summary>
+	/// Getter odległości wyznaczonych przez ostatnie wyszukiwanie
+	/// </summary>
+	/// <returns>Odległości (Traits::infinity() dla nieosiągniętych wierzchołków)</returns>
+	const std::vector<W>& get_distances() const { return dist; }
+	/// <summary>
+	/// Getter poprzedników wyznaczonych przez ostatnie wyszukiwanie
+	/// </summary>
+	/// <returns>Poprzednicy (NO_VERTEX, jeśli brak)</returns>
+	const std::vector<VertexIndex>& get_previous() const { return previous; }
+	/// <summary>
+	/// Funkcja sprawdzająca, czy wierzchołek został osiągnięty
+	/// </summary>
+	/// <param name="v">Wierzchołek</param>
+	/// <returns>true, jeśli odległość jest skończona</returns>
+	bool reached(const VertexIndex v) const { return dist[v] != Traits::infinity(); }
+	/// <summary>
+	/// Getter warunku zatrzymania (dla warunków z własnym stanem, np. policy::StopAfterTargets)
+	/// </summary>
+	/// <returns>Warunek zatrzymania</returns>
+	Stop& get_stop() { return stop_rule; }
+};
+
+/// <summary>
+/// Jądro Dijkstry dla danego typu wagi. Dla wag całkowitych wybierana jest kolejka kubełkowa,
+/// dla zmiennoprzecinkowych kopiec binarny.
+/// </summary>
+template <typename W, typename Stop = policy::StopAtTarget, typename Visited = policy::ByteVisited>
+using DijkstraKernel = SearchKernel<
+	W,
+	policy::DefaultQueue,
+	policy::NoHeuristic,
+	Visited,
+	Stop
+>;
+
+/// <summary>
+/// Jądro A* dla danego typu wagi i heurystyki. Wierzchołki mogą być otwierane ponownie,
+/// więc wynik jest poprawny także dla heurystyk, które nie są spójne.
+/// </summary>
+template <typename W, typename Heuristic, typename Stop = policy::StopAtTarget>
+using AStarKernel = SearchKernel<
+	W,
+	policy::BinaryHeapQueue,
+	Heuristic,
+	policy::NoVisited,
+	Stop
+>;
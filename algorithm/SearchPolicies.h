@@ -0,0 +1,336 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../graph/Graph.h"
+#include "../QuantizedLocalizations.h"
+
+/// <summary>
+/// Polityki parametryzujące jądro wyszukiwania (SearchKernel).
+/// Każda polityka jest zwykłą klasą bez metod wirtualnych, dzięki czemu kompilator
+/// generuje osobne, w pełni rozwinięte jądro dla każdej konfiguracji.
+/// </summary>
+namespace policy {
+
+	/// <summary>
+	/// Cechy typu wagi: wartość "nieskończoności" oraz bezpieczne dodawanie.
+	/// </summary>
+	/// <typeparam name="W">Typ wagi.</typeparam>
+	template <typename W>
+	struct WeightTraits {
+		static constexpr W infinity() {
+			if constexpr (std::numeric_limits<W>::has_infinity) {
+				return std::numeric_limits<W>::infinity();
+			}
+			else {
+				return std::numeric_limits<W>::max();
+			}
+		}
+		/// <summary>
+		/// Suma a + b; dla typów całkowitych nasyca się na infinity() zamiast przepełniać.
+		/// </summary>
+		static constexpr W add(const W a, const W b) {
+			if constexpr (std::is_integral_v<W>) {
+				return b > infinity() - a ? infinity() : static_cast<W>(a + b);
+			}
+			else {
+				return a + b;
+			}
+		}
+	};
+
+	/// <summary>
+	/// Największa waga krawędzi w listach sąsiedztwa (potrzebna kolejkom z needs_max_weight).
+	/// Wymaga przejrzenia wszystkich wag, więc przy wielu zapytaniach na tych samych listach
+	/// warto ją wyznaczyć raz i przekazywać do SearchKernel::begin().
+	/// </summary>
+	/// <typeparam name="A">Typ list sąsiedztwa.</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa</param>
+	/// <returns>Największa waga (0 dla grafu bez krawędzi)</returns>
+	template <typename A>
+	typename A::Weight max_weight(const A& adjacency) {
+		typename A::Weight result = 0;
+		for (const auto& weight : adjacency.get_weights()) {
+			result = std::max(result, weight);
+		}
+		return result;
+	}
+
+	/// <summary>
+	/// Kolejka priorytetowa na kopcu binarnym (z leniwym usuwaniem nieaktualnych wpisów).
+	/// </summary>
+	/// <typeparam name="W">Typ klucza.</typeparam>
+	template <typename W>
+	class BinaryHeapQueue {
+	private:
+		using Entry = std::pair<W, VertexIndex>;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+
+	public:
+		static constexpr bool requires_monotone_keys = false;
+		static constexpr bool needs_max_weight = false;
+
+		void reset(const W) { heap = {}; }
+		void push(const W key, const VertexIndex v) { heap.push(std::make_pair(key, v)); }
+		bool empty() const { return heap.empty(); }
+		Entry pop() {
+			const Entry top = heap.top();
+			heap.pop();
+			return top;
+		}
+	};
+
+	/// <summary>
+	/// Kolejka kubełkowa (Diala) dla całkowitych wag i monotonicznych kluczy.
+	/// Liczba kubełków równa jest największej wadze + 1, kubełki używane są cyklicznie.
+	/// </summary>
+	/// <typeparam name="W">Całkowity typ klucza.</typeparam>
+	template <typename W>
+	class BucketQueue {
+		static_assert(std::is_integral_v<W>, "BucketQueue requires integer weights");
+
+	private:
+		/// <summary>
+		/// Maksymalna obsługiwana liczba kubełków
+		/// </summary>
+		static constexpr std::size_t MAX_BUCKETS = std::size_t(1) << 24;
+
+		std::vector<std::vector<VertexIndex>> buckets;
+		W cursor = 0;
+		std::size_t size = 0;
+
+	public:
+		static constexpr bool requires_monotone_keys = true;
+		static constexpr bool needs_max_weight = true;
+
+		/// <summary>
+		/// Funkcja przygotowująca kolejkę do nowego wyszukiwania
+		/// </summary>
+		/// <param name="max_weight">Największa waga krawędzi (wyznacza liczbę kubełków)</param>
+		void reset(const W max_weight) {
+			if (static_cast<std::size_t>(max_weight) >= MAX_BUCKETS) {
+				throw std::runtime_error("bucket queue: weights too large, use a smaller weight scale");
+			}
+			buckets.assign(static_cast<std::size_t>(max_weight) + 1, {});
+			cursor = 0;
+			size = 0;
+		}
+		void push(const W key, const VertexIndex v) {
+			buckets[static_cast<std::size_t>(key) % buckets.size()].push_back(v);
+			++size;
+		}
+		bool empty() const { return size == 0; }
+		std::pair<W, VertexIndex> pop() {
+			auto* bucket = &buckets[static_cast<std::size_t>(cursor) % buckets.size()];
+			while (bucket->empty()) {
+				++cursor;
+				bucket = &buckets[static_cast<std::size_t>(cursor) % buckets.size()];
+			}
+			const VertexIndex v = bucket->back();
+			bucket->pop_back();
+			--size;
+			return std::make_pair(cursor, v);
+		}
+	};
+
+	/// <summary>
+	/// Domyślna kolejka dla typu wagi: kubełkowa dla wag całkowitych, kopiec binarny dla pozostałych.
+	/// </summary>
+	template <typename W>
+	using DefaultQueue = std::conditional_t<std::is_integral_v<W>, BucketQueue<W>, BinaryHeapQueue<W>>;
+
+	/// <summary>
+	/// Brak heurystyki (algorytm Dijkstry).
+	/// </summary>
+	struct NoHeuristic {
+		static constexpr bool enabled = false;
+
+		template <typename... Args>
+		explicit NoHeuristic(const Args&...) {}
+
+		void evaluate(const VertexIndex*, const std::size_t, double*) const {}
+	};
+
+	/// <summary>
+	/// Heurystyka euklidesowa liczona wsadowo na lokalizacjach w układzie struktury tablic.
+	/// </summary>
+	/// <typeparam name="L">Magazyn lokalizacji (Localizations, QuantizedLocalizations).</typeparam>
+	template <typename L>
+	class BasicEuclideanHeuristic {
+	private:
+		const L& localizations;
+		const Localization target;
+		const double scale;
+
+	public:
+		static constexpr bool enabled = true;
+
+		BasicEuclideanHeuristic(const L& localizations, const Localization& target, const double scale = 1.0) :
+			localizations(localizations),
+			target(target),
+			scale(scale)
+		{}
+		template <typename G>
+		BasicEuclideanHeuristic(const G& graph, const VertexIndex target, const double scale = 1.0) :
+			localizations(graph.get_localizations()),
+			target(graph.get_localizations().at(target)),
+			scale(scale)
+		{}
+
+		void evaluate(const VertexIndex* vertices, const std::size_t count, double* out) const {
+			localizations.heuristic_distances(target, vertices, count, out);
+			if (scale != 1.0) {
+				for (std::size_t i = 0; i < count; ++i) {
+					out[i] *= scale;
+				}
+			}
+		}
+	};
+
+	/// <summary>
+	/// Heurystyka euklidesowa na pełnych współrzędnych (Graph).
+	/// </summary>
+	using EuclideanHeuristic = BasicEuclideanHeuristic<Localizations>;
+
+	/// <summary>
+	/// Heurystyka euklidesowa na współrzędnych skwantowanych (CompactGraph), pomniejszona o błąd kwantyzacji.
+	/// </summary>
+	using QuantizedEuclideanHeuristic = BasicEuclideanHeuristic<QuantizedLocalizations<>>;
+
+	/// <summary>
+	/// Heurystyka wyznaczana przez Vertex::heuristic_distance, dla danych wierzchołków bez lokalizacji.
+	/// </summary>
+	/// <typeparam name="T">Typ danych wierzchołka.</typeparam>
+	template <typename T>
+	class VertexHeuristic {
+	private:
+		const Graph<T>& graph;
+		const VertexSPtr<T>& target;
+		const double scale;
+
+	public:
+		static constexpr bool enabled = true;
+
+		VertexHeuristic(const Graph<T>& graph, const VertexIndex target, const double scale = 1.0) :
+			graph(graph),
+			target(graph.get_vertices()[target]),
+			scale(scale)
+		{}
+
+		void evaluate(const VertexIndex* vertices, const std::size_t count, double* out) const {
+			for (std::size_t i = 0; i < count; ++i) {
+				out[i] = graph.get_vertices()[vertices[i]]->heuristic_distance(*target) * scale;
+			}
+		}
+	};
+
+	/// <summary>
+	/// Domyślna heurystyka dla typu danych wierzchołka: euklidesowa, jeśli dane mają lokalizację.
+	/// </summary>
+	template <typename T>
+	using DefaultHeuristic = std::conditional_t<has_localization<T>::value, EuclideanHeuristic, VertexHeuristic<T>>;
+
+	/// <summary>
+	/// Brak zbioru odwiedzonych: wierzchołki mogą być przetwarzane ponownie
+	/// (wymagane przy heurystyce, która nie jest spójna).
+	/// </summary>
+	struct NoVisited {
+		void reset(const std::size_t) {}
+		bool test_and_set(const VertexIndex) { return false; }
+		bool contains(const VertexIndex) const { return false; }
+	};
+
+	/// <summary>
+	/// Zbiór odwiedzonych jako tablica bajtów.
+	/// </summary>
+	class ByteVisited {
+	private:
+		std::vector<std::uint8_t> visited;
+
+	public:
+		void reset(const std::size_t n) { visited.assign(n, 0); }
+		bool test_and_set(const VertexIndex v) {
+			const bool was = visited[v] != 0;
+			visited[v] = 1;
+			return was;
+		}
+		bool contains(const VertexIndex v) const { return visited[v] != 0; }
+	};
+
+	/// <summary>
+	/// Zbiór odwiedzonych jako mapa bitowa (8x mniej pamięci niż ByteVisited).
+	/// </summary>
+	class BitsetVisited {
+	private:
+		std::vector<std::uint64_t> words;
+
+	public:
+		void reset(const std::size_t n) { words.assign((n + 63) / 64, 0); }
+		bool test_and_set(const VertexIndex v) {
+			const std::uint64_t bit = std::uint64_t(1) << (v % 64);
+			const bool was = (words[v / 64] & bit) != 0;
+			words[v / 64] |= bit;
+			return was;
+		}
+		bool contains(const VertexIndex v) const { return (words[v / 64] >> (v % 64)) & 1; }
+	};
+
+	/// <summary>
+	/// Zatrzymanie po zdjęciu z kolejki wierzchołka docelowego (zapytanie punkt-punkt).
+	/// </summary>
+	struct StopAtTarget {
+		static constexpr bool stop(const VertexIndex current, const VertexIndex target) { return current == target; }
+	};
+
+	/// <summary>
+	/// Zatrzymanie po zdjęciu z kolejki wszystkich zadanych wierzchołków docelowych (zapytanie jeden-do-wielu).
+	/// Cele należy ustawić przez set_targets przed każdym uruchomieniem jądra.
+	/// Wymaga zbioru odwiedzonych (każdy wierzchołek zdejmowany jest z kolejki co najwyżej raz).
+	/// </summary>
+	class StopAfterTargets {
+	private:
+		std::vector<char> is_target;
+		std::vector<VertexIndex> targets;
+		std::size_t remaining = 0;
+
+	public:
+		void set_targets(const std::size_t vertex_count, const std::vector<VertexIndex>& new_targets) {
+			for (const VertexIndex v : targets) {
+				if (v < is_target.size()) {
+					is_target[v] = 0;
+				}
+			}
+			is_target.resize(vertex_count, 0);
+			targets.clear();
+			for (const VertexIndex v : new_targets) {
+				if (!is_target[v]) {
+					is_target[v] = 1;
+					targets.push_back(v);
+				}
+			}
+			remaining = targets.size();
+		}
+		bool stop(const VertexIndex current, const VertexIndex) {
+			if (is_target[current]) {
+				--remaining;
+			}
+			return remaining == 0;
+		}
+	};
+
+	/// <summary>
+	/// Przeszukanie całego osiągalnego grafu (drzewo najkrótszych ścieżek z jednego źródła).
+	/// </summary>
+	struct ExhaustAll {
+		static constexpr bool stop(const VertexIndex, const VertexIndex) { return false; }
+	};
+}
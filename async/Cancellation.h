@@ -0,0 +1,96 @@
+﻿#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+/// <summary>
+/// Stan zakończenia zapytania asynchronicznego.
+/// </summary>
+enum class QueryStatus {
+	/// <summary>
+	/// Wyszukiwanie zakończone - wynik jest ostateczny
+	/// </summary>
+	COMPLETED,
+	/// <summary>
+	/// Zapytanie anulowane przez CancellationToken
+	/// </summary>
+	CANCELLED,
+	/// <summary>
+	/// Upłynął termin zapytania
+	/// </summary>
+	DEADLINE_EXPIRED
+};
+
+/// <summary>
+/// Token anulowania współdzielony przez kopie: cancel() na dowolnej kopii (z dowolnego wątku)
+/// zatrzymuje zapytania, które go otrzymały, w najbliższym punkcie wstrzymania.
+/// </summary>
+class CancellationToken
+{
+private:
+	std::shared_ptr<std::atomic<bool>> cancelled;
+
+public:
+	/// <summary>
+	/// Konstruktor tworzący nowy, nieanulowany token
+	/// </summary>
+	CancellationToken() : cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+public:
+	/// <summary>
+	/// Funkcja anulująca wszystkie zapytania korzystające z tokenu
+	/// </summary>
+	void cancel() const { cancelled->store(true, std::memory_order_relaxed); }
+	/// <summary>
+	/// Czy token został anulowany
+	/// </summary>
+	bool is_cancelled() const { return cancelled->load(std::memory_order_relaxed); }
+};
+
+/// <summary>
+/// Ograniczenia zapytania asynchronicznego: token anulowania, termin oraz liczba kroków wyszukiwania
+/// między kolejnymi punktami wstrzymania (np. zdjęć wierzchołków z kolejki).
+/// </summary>
+struct QueryLimits {
+	using Clock = std::chrono::steady_clock;
+
+	CancellationToken cancellation;
+	/// <summary>
+	/// Termin zapytania (domyślnie brak)
+	/// </summary>
+	Clock::time_point deadline = Clock::time_point::max();
+	/// <summary>
+	/// Liczba kroków wyszukiwania między punktami wstrzymania
+	/// </summary>
+	std::size_t slice = 4096;
+
+	/// <summary>
+	/// Funkcja tworząca ograniczenia z terminem liczonym od teraz
+	/// </summary>
+	/// <param name="timeout">Czas na wykonanie zapytania</param>
+	/// <param name="cancellation">Token anulowania</param>
+	/// <returns>Ograniczenia</returns>
+	static QueryLimits within(const Clock::duration timeout, CancellationToken cancellation = CancellationToken()) {
+		QueryLimits limits;
+		limits.cancellation = std::move(cancellation);
+		limits.deadline = Clock::now() + timeout;
+		return limits;
+	}
+
+	/// <summary>
+	/// Funkcja sprawdzająca, czy zapytanie należy przerwać
+	/// </summary>
+	/// <returns>Powód przerwania (CANCELLED lub DEADLINE_EXPIRED), lub std::nullopt jeśli można kontynuować</returns>
+	std::optional<QueryStatus> stop_reason() const {
+		if (cancellation.is_cancelled()) {
+			return QueryStatus::CANCELLED;
+		}
+		if (deadline != Clock::time_point::max() && Clock::now() >= deadline) {
+			return QueryStatus::DEADLINE_EXPIRED;
+		}
+		return std::nullopt;
+	}
+};
@@ -0,0 +1,69 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <utility>
+
+#include "QueryTask.h"
+
+/// <summary>
+/// Planista przeplatający wiele zapytań (QueryTask) w jednym wątku: w każdej rundzie wznawia po kolei
+/// każde aktywne zapytanie do jego najbliższego punktu wstrzymania. Krótkie zapytania kończą się więc
+/// po kilku rundach, nawet gdy obok wykonuje się zapytanie długie. Klasa nie jest bezpieczna wątkowo.
+/// </summary>
+/// <typeparam name="R">Typ wyniku zapytań.</typeparam>
+template <typename R>
+class QueryScheduler
+{
+public:
+	/// <summary>
+	/// Funkcja wywoływana po zakończeniu zapytania; wynik odczytuje się przez task.get(), które rzuca
+	/// wyjątek zapytania, jeśli taki wystąpił.
+	/// </summary>
+	using Completion = std::function<void(QueryTask<R>& task)>;
+
+private:
+	struct Entry {
+		QueryTask<R> task;
+		Completion on_done;
+	};
+
+	std::list<Entry> active;
+
+public:
+	/// <summary>
+	/// Funkcja dodająca zapytanie
+	/// </summary>
+	/// <param name="task">Korutyna zapytania</param>
+	/// <param name="on_done">Funkcja wywoływana po jego zakończeniu</param>
+	void submit(QueryTask<R> task, Completion on_done) {
+		active.push_back(Entry{ std::move(task), std::move(on_done) });
+	}
+	/// <summary>
+	/// Funkcja wykonująca jedną rundę: każde aktywne zapytanie wznawiane jest raz
+	/// </summary>
+	/// <returns>true, jeśli pozostały aktywne zapytania</returns>
+	bool run_once() {
+		for (auto it = active.begin(); it != active.end();) {
+			if (it->task.resume()) {
+				it->on_done(it->task);
+				it = active.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+		return !active.empty();
+	}
+	/// <summary>
+	/// Funkcja wykonująca rundy aż do zakończenia wszystkich zapytań
+	/// </summary>
+	void run() {
+		while (run_once()) {}
+	}
+	/// <summary>
+	/// Liczba aktywnych zapytań
+	/// </summary>
+	std::size_t size() const { return active.size(); }
+};
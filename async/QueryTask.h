@@ -0,0 +1,96 @@
+﻿#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+/// <summary>
+/// Korutyna zapytania zwracająca wartość typu R. Korutyna startuje leniwie i wykonuje się fragmentami:
+/// każde resume() dochodzi do najbliższego punktu wstrzymania (co_await std::suspend_always{})
+/// albo do końca. Pozwala to jednemu wątkowi przeplatać wiele zapytań (QueryScheduler).
+/// Obiekty przekazane do korutyny przez referencję muszą istnieć aż do jej zakończenia.
+/// </summary>
+/// <typeparam name="R">Typ wyniku.</typeparam>
+template <typename R>
+class QueryTask
+{
+public:
+	struct promise_type {
+		std::optional<R> value;
+		std::exception_ptr error;
+
+		QueryTask get_return_object() { return QueryTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_value(R result) { value.emplace(std::move(result)); }
+		void unhandled_exception() { error = std::current_exception(); }
+	};
+
+private:
+	std::coroutine_handle<promise_type> handle;
+
+	explicit QueryTask(const std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+public:
+	QueryTask(QueryTask&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+	QueryTask& operator=(QueryTask&& other) noexcept {
+		if (this != &other) {
+			if (handle) {
+				handle.destroy();
+			}
+			handle = std::exchange(other.handle, {});
+		}
+		return *this;
+	}
+	QueryTask(const QueryTask&) = delete;
+	QueryTask& operator=(const QueryTask&) = delete;
+	~QueryTask() {
+		if (handle) {
+			handle.destroy();
+		}
+	}
+
+public:
+	/// <summary>
+	/// Czy korutyna się zakończyła
+	/// </summary>
+	bool done() const { return !handle || handle.done(); }
+	/// <summary>
+	/// Funkcja wykonująca kolejny fragment korutyny
+	/// </summary>
+	/// <returns>true, jeśli korutyna się zakończyła</returns>
+	bool resume() {
+		if (!done()) {
+			handle.resume();
+		}
+		return done();
+	}
+	/// <summary>
+	/// Funkcja zwracająca wynik zakończonej korutyny (lub rzucająca wyjątek, który ją przerwał).
+	/// Dla obiektu przeniesionego rzuca std::logic_error.
+	/// </summary>
+	/// <returns>Wynik</returns>
+	R get() {
+		if (!handle) {
+			throw std::logic_error("query task has no coroutine (moved from)");
+		}
+		if (!done()) {
+			throw std::logic_error("query task has not finished");
+		}
+		promise_type& promise = handle.promise();
+		if (promise.error) {
+			std::rethrow_exception(promise.error);
+		}
+		return std::move(*promise.value);
+	}
+	/// <summary>
+	/// Funkcja wykonująca korutynę do końca w bieżącym wątku
+	/// </summary>
+	/// <returns>Wynik</returns>
+	R wait() {
+		while (!resume()) {}
+		return get();
+	}
+};
@@ -0,0 +1,302 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ShardedLruCache.h"
+#include "../algorithm/Algorithm.h"
+
+/// <summary>
+/// Klucz zapytania w pamięci podręcznej.
+/// Wersja grafu jest unikalna w obrębie procesu, więc identyfikuje zarówno graf, jak i stan jego wag.
+/// </summary>
+struct QueryKey {
+	std::string algorithm;
+	VertexIndex start = NO_VERTEX;
+	VertexIndex end = NO_VERTEX;
+	std::uint64_t options = 0;
+	std::uint64_t graph_version = 0;
+
+	bool operator==(const QueryKey& other) const {
+		return start == other.start
+			&& end == other.end
+			&& options == other.options
+			&& graph_version == other.graph_version
+			&& algorithm == other.algorithm;
+	}
+};
+
+/// <summary>
+/// Klucz drzewa najkrótszych ścieżek (algorytm, opcje, źródło i wersja grafu).
+/// </summary>
+struct TreeKey {
+	std::string algorithm;
+	std::uint64_t options = 0;
+	VertexIndex source = NO_VERTEX;
+	std::uint64_t graph_version = 0;
+
+	bool operator==(const TreeKey& other) const {
+		return source == other.source
+			&& graph_version == other.graph_version
+			&& options == other.options
+			&& algorithm == other.algorithm;
+	}
+};
+
+/// <summary>
+/// Funkcja mieszająca kolejne wartości skrótu (wariant boost::hash_combine).
+/// </summary>
+inline std::size_t hash_combine(const std::size_t seed, const std::size_t value) {
+	return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+struct QueryKeyHash {
+	std::size_t operator()(const QueryKey& key) const {
+		std::size_t h = std::hash<std::string>()(key.algorithm);
+		h = hash_combine(h, key.start);
+		h = hash_combine(h, key.end);
+		h = hash_combine(h, static_cast<std::size_t>(key.options));
+		return hash_combine(h, static_cast<std::size_t>(key.graph_version));
+	}
+};
+
+struct TreeKeyHash {
+	std::size_t operator()(const TreeKey& key) const {
+		std::size_t h = std::hash<std::string>()(key.algorithm);
+		h = hash_combine(h, static_cast<std::size_t>(key.options));
+		h = hash_combine(h, key.source);
+		return hash_combine(h, static_cast<std::size_t>(key.graph_version));
+	}
+};
+
+/// <summary>
+/// Drzewo najkrótszych ścieżek z jednego źródła (odległości i poprzednicy wszystkich wierzchołków).
+/// </summary>
+struct ShortestPathTree {
+	std::vector<double> dist;
+	std::vector<VertexIndex> previous;
+
+	std::size_t bytes() const { return bytes_for(dist.size()); }
+	/// <summary>
+	/// Rozmiar drzewa dla grafu o danej liczbie wierzchołków
+	/// </summary>
+	static std::size_t bytes_for(const std::size_t vertex_count) {
+		return sizeof(ShortestPathTree) + vertex_count * (sizeof(double) + sizeof(VertexIndex));
+	}
+};
+
+/// <summary>
+/// Konfiguracja pamięci podręcznej zapytań.
+/// </summary>
+struct QueryCacheConfig {
+	/// <summary>
+	/// Limit pamięci na wyniki punkt-punkt
+	/// </summary>
+	std::size_t max_bytes = std::size_t(64) << 20;
+	/// <summary>
+	/// Limit pamięci na drzewa najkrótszych ścieżek
+	/// </summary>
+	std::size_t tree_max_bytes = std::size_t(64) << 20;
+	/// <summary>
+	/// Liczba segmentów (shardów) każdej z pamięci
+	/// </summary>
+	std::size_t shards = 16;
+	/// <summary>
+	/// Liczba chybień z danego źródła, po której wyznaczane jest drzewo najkrótszych ścieżek (0 - wyłączone)
+	/// </summary>
+	unsigned int hot_source_threshold = 16;
+	/// <summary>
+	/// Maksymalna liczba zestawów liczników chybień (wersja grafu, algorytm i opcje); najdawniej używane są usuwane
+	/// </summary>
+	std::size_t max_source_states = 8;
+};
+
+/// <summary>
+/// Pamięć podręczna wyników SolveResult oraz drzew najkrótszych ścieżek z często odpytywanych źródeł.
+/// Zmiana wag grafu zmienia jego wersję, więc wpisy dla poprzedniej wersji nie są już trafiane
+/// i są stopniowo usuwane przez LRU; clear() usuwa je natychmiast.
+/// </summary>
+/// <typeparam name="T">Typ wierzchołków grafu.</typeparam>
+template <typename T>
+class QueryCache
+{
+public:
+	using Result = std::optional<SolveResult<T>>;
+	using ResultPtr = std::shared_ptr<const Result>;
+	using TreePtr = std::shared_ptr<const ShortestPathTree>;
+
+private:
+	const QueryCacheConfig config;
+	ShardedLruCache<QueryKey, Result, QueryKeyHash> results;
+	ShardedLruCache<TreeKey, ShortestPathTree, TreeKeyHash> trees;
+
+	/// <summary>
+	/// Stan źródeł jednej wersji grafu: liczniki chybień (od ostatniej budowy drzewa) oraz znaczniki źródeł,
+	/// dla których zapamiętano drzewo
+	/// </summary>
+	struct SourceState {
+		std::vector<unsigned int> misses;
+		std::vector<char> has_tree;
+		std::uint64_t last_used = 0;
+	};
+	/// <summary>
+	/// Klucz stanu źródeł: wersja grafu (unikalna w obrębie procesu, więc identyfikuje też graf) oraz algorytm i jego opcje
+	/// </summary>
+	struct SourcesKey {
+		std::string algorithm;
+		std::uint64_t options = 0;
+		std::uint64_t graph_version = 0;
+
+		bool operator==(const SourcesKey& other) const {
+			return graph_version == other.graph_version && options == other.options && algorithm == other.algorithm;
+		}
+	};
+	struct SourcesKeyHash {
+		std::size_t operator()(const SourcesKey& key) const {
+			std::size_t h = std::hash<std::string>()(key.algorithm);
+			h = hash_combine(h, static_cast<std::size_t>(key.options));
+			return hash_combine(h, static_cast<std::size_t>(key.graph_version));
+		}
+	};
+
+	/// <summary>
+	/// Stan źródeł dla co najwyżej max_source_states kluczy. Stan wersji, której graf zmienił wagi lub został
+	/// usunięty, nie jest już używany i zostaje usunięty jako najdawniej używany.
+	/// </summary>
+	std::mutex sources_mutex;
+	std::unordered_map<SourcesKey, SourceState, SourcesKeyHash> sources;
+	std::uint64_t sources_clock = 0;
+
+public:
+	/// <summary>
+	/// Konstruktor klasy QueryCache
+	/// </summary>
+	/// <param name="config">Konfiguracja</param>
+	QueryCache(const QueryCacheConfig& config = QueryCacheConfig()) :
+		config(config),
+		results(config.max_bytes, config.shards),
+		trees(config.tree_max_bytes, config.shards)
+	{}
+
+public:
+	/// <summary>
+	/// Funkcja wyszukująca wynik zapytania
+	/// </summary>
+	/// <param name="key">Klucz zapytania</param>
+	/// <returns>Wynik (także zapamiętany brak ścieżki), lub nullptr przy chybieniu</returns>
+	ResultPtr find(const QueryKey& key) { return results.find(key); }
+	/// <summary>
+	/// Funkcja zapamiętująca wynik zapytania
+	/// </summary>
+	/// <param name="key">Klucz zapytania</param>
+	/// <param name="result">Wynik</param>
+	void insert(const QueryKey& key, const Result& result) {
+		const std::size_t bytes = sizeof(QueryKey) + key.algorithm.size() + sizeof(Result)
+			+ (result ? result->get_path().size() * sizeof(VertexSPtr<T>) : 0);
+		results.insert(key, std::make_shared<const Result>(result), bytes);
+	}
+	/// <summary>
+	/// Funkcja wyszukująca drzewo najkrótszych ścieżek ze źródła key.start dla algorytmu, opcji i wersji grafu z klucza.
+	/// Pamięć drzew przeszukiwana jest tylko dla źródeł, dla których drzewo zostało zapamiętane.
+	/// </summary>
+	/// <param name="graph">Graf</param>
+	/// <param name="key">Klucz zapytania</param>
+	/// <returns>Drzewo, lub nullptr jeśli go nie ma (nie zostało zbudowane albo zostało usunięte)</returns>
+	TreePtr find_tree(const Graph<T>& graph, const QueryKey& key) {
+		{
+			std::lock_guard<std::mutex> lock(sources_mutex);
+			if (!state_for(graph, key).has_tree[key.start]) {
+				return nullptr;
+			}
+		}
+		TreePtr tree = trees.find(tree_key(key));
+		if (!tree) {
+			// Drzewo zostało usunięte przez LRU - kolejne zapytania nie muszą go już szukać.
+			std::lock_guard<std::mutex> lock(sources_mutex);
+			state_for(graph, key).has_tree[key.start] = 0;
+		}
+		return tree;
+	}
+	/// <summary>
+	/// Funkcja zapamiętująca drzewo najkrótszych ścieżek ze źródła key.start
+	/// </summary>
+	/// <param name="graph">Graf</param>
+	/// <param name="key">Klucz zapytania</param>
+	/// <param name="tree">Drzewo</param>
+	void insert_tree(const Graph<T>& graph, const QueryKey& key, TreePtr tree) {
+		const std::size_t bytes = tree->bytes();
+		if (!trees.fits(bytes)) {
+			return;
+		}
+		trees.insert(tree_key(key), std::move(tree), bytes);
+		std::lock_guard<std::mutex> lock(sources_mutex);
+		state_for(graph, key).has_tree[key.start] = 1;
+	}
+	/// <summary>
+	/// Funkcja rejestrująca chybienie dla źródła key.start. Po przekroczeniu progu licznik jest zerowany, więc drzewo
+	/// usunięte z pamięci jest budowane ponownie dopiero po kolejnych hot_source_threshold chybieniach.
+	/// </summary>
+	/// <param name="graph">Graf</param>
+	/// <param name="key">Klucz zapytania</param>
+	/// <returns>true, jeśli źródło przekroczyło próg, a jego drzewo zmieści się w pamięci - warto je wyznaczyć</returns>
+	bool record_miss(const Graph<T>& graph, const QueryKey& key) {
+		if (config.hot_source_threshold == 0
+			|| !trees.fits(ShortestPathTree::bytes_for(graph.get_vertices().size()))) {
+			return false;
+		}
+		std::lock_guard<std::mutex> lock(sources_mutex);
+		unsigned int& misses = state_for(graph, key).misses[key.start];
+		if (++misses < config.hot_source_threshold) {
+			return false;
+		}
+		misses = 0;
+		return true;
+	}
+	/// <summary>
+	/// Funkcja usuwająca wszystkie zapamiętane wyniki i drzewa
+	/// </summary>
+	void clear() {
+		results.clear();
+		trees.clear();
+		std::lock_guard<std::mutex> lock(sources_mutex);
+		sources.clear();
+	}
+	/// <summary>
+	/// Statystyki pamięci wyników punkt-punkt
+	/// </summary>
+	CacheStats result_stats() const { return results.stats(); }
+	/// <summary>
+	/// Statystyki pamięci drzew najkrótszych ścieżek
+	/// </summary>
+	CacheStats tree_stats() const { return trees.stats(); }
+
+private:
+	static TreeKey tree_key(const QueryKey& key) {
+		return TreeKey{ key.algorithm, key.options, key.start, key.graph_version };
+	}
+	SourceState& state_for(const Graph<T>& graph, const QueryKey& key) {
+		SourcesKey sources_key{ key.algorithm, key.options, key.graph_version };
+		auto it = sources.find(sources_key);
+		if (it == sources.end()) {
+			if (sources.size() >= std::max<std::size_t>(1, config.max_source_states)) {
+				sources.erase(std::min_element(sources.begin(), sources.end(), [](const auto& a, const auto& b) {
+					return a.second.last_used < b.second.last_used;
+				}));
+			}
+			it = sources.emplace(std::move(sources_key), SourceState()).first;
+			const std::size_t n = graph.get_vertices().size();
+			it->second.misses.assign(n, 0);
+			it->second.has_tree.assign(n, 0);
+		}
+		it->second.last_used = ++sources_clock;
+		return it->second;
+	}
+};
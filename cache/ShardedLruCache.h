@@ -0,0 +1,179 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Statystyki pamięci podręcznej.
+/// </summary>
+struct CacheStats {
+	std::uint64_t hits = 0;
+	std::uint64_t misses = 0;
+	std::uint64_t insertions = 0;
+	std::uint64_t evictions = 0;
+	std::size_t entries = 0;
+	std::size_t bytes = 0;
+
+	/// <summary>
+	/// Współczynnik trafień
+	/// </summary>
+	/// <returns>hits / (hits + misses), lub 0 gdy nie było zapytań</returns>
+	double hit_ratio() const {
+		const std::uint64_t total = hits + misses;
+		return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+	}
+};
+
+/// <summary>
+/// Współbieżna pamięć podręczna LRU podzielona na niezależne segmenty (shardy).
+/// Każdy segment ma własną blokadę, listę LRU i limit pamięci równy max_bytes / liczba segmentów.
+/// Wartości przechowywane są jako std::shared_ptr, więc odczyt nie kopiuje danych pod blokadą.
+/// </summary>
+/// <typeparam name="K">Typ klucza.</typeparam>
+/// <typeparam name="V">Typ wartości.</typeparam>
+/// <typeparam name="Hash">Funkcja skrótu klucza.</typeparam>
+template <typename K, typename V, typename Hash = std::hash<K>>
+class ShardedLruCache
+{
+public:
+	using ValuePtr = std::shared_ptr<const V>;
+
+private:
+	struct Entry {
+		K key;
+		ValuePtr value;
+		std::size_t bytes;
+	};
+
+	struct Shard {
+		std::mutex mutex;
+		std::list<Entry> lru;
+		std::unordered_map<K, typename std::list<Entry>::iterator, Hash> index;
+		std::size_t bytes = 0;
+	};
+
+private:
+	/// <summary>
+	/// Segmenty pamięci podręcznej
+	/// </summary>
+	std::vector<std::unique_ptr<Shard>> shards;
+	/// <summary>
+	/// Limit pamięci pojedynczego segmentu
+	/// </summary>
+	const std::size_t shard_max_bytes;
+	Hash hash;
+
+	std::atomic<std::uint64_t> hits{ 0 };
+	std::atomic<std::uint64_t> misses{ 0 };
+	std::atomic<std::uint64_t> insertions{ 0 };
+	std::atomic<std::uint64_t> evictions{ 0 };
+
+public:
+	/// <summary>
+	/// Konstruktor klasy ShardedLruCache
+	/// </summary>
+	/// <param name="max_bytes">Łączny limit pamięci (szacowany rozmiar wpisów)</param>
+	/// <param name="shard_count">Liczba segmentów</param>
+	ShardedLruCache(const std::size_t max_bytes, const std::size_t shard_count = 16) :
+		shard_max_bytes(max_bytes / (shard_count == 0 ? 1 : shard_count))
+	{
+		for (std::size_t i = 0; i < (shard_count == 0 ? 1 : shard_count); ++i) {
+			shards.push_back(std::make_unique<Shard>());
+		}
+	}
+
+public:
+	/// <summary>
+	/// Funkcja wyszukująca wartość i oznaczająca ją jako ostatnio używaną.
+	/// </summary>
+	/// <param name="key">Klucz</param>
+	/// <returns>Wartość, lub nullptr jeśli klucza nie ma w pamięci podręcznej</returns>
+	ValuePtr find(const K& key) {
+		Shard& shard = shard_for(key);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		const auto it = shard.index.find(key);
+		if (it == shard.index.end()) {
+			++misses;
+			return nullptr;
+		}
+		shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+		++hits;
+		return it->second->value;
+	}
+	/// <summary>
+	/// Czy wpis o danym rozmiarze zmieści się w limicie segmentu (większe wpisy nie są zapamiętywane)
+	/// </summary>
+	/// <param name="bytes">Szacowany rozmiar wpisu w bajtach</param>
+	bool fits(const std::size_t bytes) const { return bytes <= shard_max_bytes; }
+	/// <summary>
+	/// Funkcja wstawiająca (lub zastępująca) wartość. Najdawniej używane wpisy są usuwane
+	/// do momentu zmieszczenia się w limicie segmentu. Wpis większy niż limit segmentu nie jest zapamiętywany.
+	/// </summary>
+	/// <param name="key">Klucz</param>
+	/// <param name="value">Wartość</param>
+	/// <param name="bytes">Szacowany rozmiar wpisu w bajtach</param>
+	void insert(const K& key, ValuePtr value, const std::size_t bytes) {
+		if (bytes > shard_max_bytes) {
+			return;
+		}
+		Shard& shard = shard_for(key);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		const auto it = shard.index.find(key);
+		if (it != shard.index.end()) {
+			shard.bytes -= it->second->bytes;
+			shard.lru.erase(it->second);
+			shard.index.erase(it);
+		}
+		while (!shard.lru.empty() && shard.bytes + bytes > shard_max_bytes) {
+			shard.bytes -= shard.lru.back().bytes;
+			shard.index.erase(shard.lru.back().key);
+			shard.lru.pop_back();
+			++evictions;
+		}
+		shard.lru.push_front(Entry{ key, std::move(value), bytes });
+		shard.index.insert(std::make_pair(key, shard.lru.begin()));
+		shard.bytes += bytes;
+		++insertions;
+	}
+	/// <summary>
+	/// Funkcja usuwająca wszystkie wpisy (statystyki trafień są zachowywane).
+	/// </summary>
+	void clear() {
+		for (auto& shard : shards) {
+			std::lock_guard<std::mutex> lock(shard->mutex);
+			shard->lru.clear();
+			shard->index.clear();
+			shard->bytes = 0;
+		}
+	}
+	/// <summary>
+	/// Funkcja zwracająca statystyki pamięci podręcznej
+	/// </summary>
+	/// <returns>Statystyki</returns>
+	CacheStats stats() const {
+		CacheStats result;
+		result.hits = hits;
+		result.misses = misses;
+		result.insertions = insertions;
+		result.evictions = evictions;
+		for (const auto& shard : shards) {
+			std::lock_guard<std::mutex> lock(shard->mutex);
+			result.entries += shard->lru.size();
+			result.bytes += shard->bytes;
+		}
+		return result;
+	}
+
+private:
+	Shard& shard_for(const K& key) {
+		return *shards[hash(key) % shards.size()];
+	}
+};
@@ -0,0 +1,224 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Typ indeksu wierzchołka w zwartej reprezentacji grafu.
+/// </summary>
+using VertexIndex = unsigned int;
+
+/// <summary>
+/// Wartość oznaczająca brak wierzchołka (np. brak poprzednika na ścieżce).
+/// </summary>
+constexpr VertexIndex NO_VERTEX = std::numeric_limits<VertexIndex>::max();
+
+/// <summary>
+/// Klasa reprezentująca listy sąsiedztwa grafu w formacie CSR (compressed sparse row).
+/// Krawędzie wychodzące z wierzchołka v zajmują ciągły zakres [offsets[v], offsets[v + 1])
+/// w tablicach targets i weights, co pozwala na wektorowe przetwarzanie wag.
+/// </summary>
+/// <typeparam name="W">Typ wagi krawędzi.</typeparam>
+template <typename W = double>
+class Adjacency
+{
+public:
+	using Weight = W;
+	/// <summary>
+	/// Bufor pomocniczy do odczytu wiersza (nieużywany - wiersze są przechowywane w postaci jawnej).
+	/// </summary>
+	struct Scratch {};
+	/// <summary>
+	/// Widok krawędzi wychodzących z jednego wierzchołka.
+	/// </summary>
+	struct Row {
+		const VertexIndex* targets;
+		const W* weights;
+		std::size_t count;
+	};
+
+private:
+	/// <summary>
+	/// Początki list sąsiedztwa kolejnych wierzchołków (rozmiar: liczba wierzchołków + 1)
+	/// </summary>
+	std::vector<std::size_t> offsets;
+	/// <summary>
+	/// Wierzchołki docelowe krawędzi
+	/// </summary>
+	std::vector<VertexIndex> targets;
+	/// <summary>
+	/// Wagi krawędzi
+	/// </summary>
+	std::vector<W> weights;
+
+public:
+	/// <summary>
+	/// Konstruktor domyślny
+	/// </summary>
+	Adjacency() : offsets(1, 0) {}
+	/// <summary>
+	/// Konstruktor tworzący listy sąsiedztwa z listy krawędzi (from, to, waga).
+	/// </summary>
+	/// <param name="vertex_count">Liczba wierzchołków</param>
+	/// <param name="edges">Lista krawędzi</param>
+	/// <param name="positions">Opcjonalnie: pozycje kolejnych krawędzi z listy w tablicach targets/weights</param>
+	Adjacency(
+		const std::size_t vertex_count,
+		const std::vector<std::pair<std::pair<VertexIndex, VertexIndex>, W>>& edges,
+		std::vector<std::size_t>* positions = nullptr
+	) :
+		offsets(vertex_count + 1, 0),
+		targets(edges.size()),
+		weights(edges.size())
+	{
+		for (const auto& [ends, _] : edges) {
+			++offsets[ends.first + 1];
+		}
+		for (std::size_t v = 0; v < vertex_count; ++v) {
+			offsets[v + 1] += offsets[v];
+		}
+		std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+		if (positions) {
+			positions->resize(edges.size());
+		}
+		for (std::size_t i = 0; i < edges.size(); ++i) {
+			const auto& [ends, weight] = edges[i];
+			const std::size_t e = next[ends.first]++;
+			targets[e] = ends.second;
+			weights[e] = weight;
+			if (positions) {
+				(*positions)[i] = e;
+			}
+		}
+	}
+
+public:
+	/// <summary>
+	/// Liczba wierzchołków
+	/// </summary>
+	/// <returns>Liczba wierzchołków</returns>
+	std::size_t vertex_count() const { return offsets.size() - 1; }
+	/// <summary>
+	/// Liczba krawędzi
+	/// </summary>
+	/// <returns>Liczba krawędzi</returns>
+	std::size_t edge_count() const { return targets.size(); }
+	/// <summary>
+	/// Indeks pierwszej krawędzi wychodzącej z wierzchołka
+	/// </summary>
+	/// <param name="v">Wierzchołek</param>
+	/// <returns>Indeks krawędzi</returns>
+	std::size_t begin(const VertexIndex v) const { return offsets[v]; }
+	/// <summary>
+	/// Indeks za ostatnią krawędzią wychodzącą z wierzchołka
+	/// </summary>
+	/// <param name="v">Wierzchołek</param>
+	/// <returns>Indeks krawędzi</returns>
+	std::size_t end(const VertexIndex v) const { return offsets[v + 1]; }
+	/// <summary>
+	/// Stopień wyjściowy wierzchołka
+	/// </summary>
+	/// <param name="v">Wierzchołek</param>
+	/// <returns>Liczba krawędzi wychodzących</returns>
+	std::size_t degree(const VertexIndex v) const { return offsets[v + 1] - offsets[v]; }
+	/// <summary>
+	/// Widok krawędzi wychodzących z wierzchołka
+	/// </summary>
+	/// <param name="v">Wierzchołek</param>
+	/// <returns>Wierzchołki docelowe i wagi krawędzi</returns>
+	Row row(const VertexIndex v, Scratch&) const {
+		return Row{ targets.data() + offsets[v], weights.data() + offsets[v], degree(v) };
+	}
+	/// <summary>
+	/// Getter tablicy wierzchołków docelowych
+	/// </summary>
+	/// <returns>Wierzchołki docelowe krawędzi</returns>
+	const std::vector<VertexIndex>& get_targets() const { return targets; }
+	/// <summary>
+	/// Getter tablicy wag
+	/// </summary>
+	/// <returns>Wagi krawędzi</returns>
+	const std::vector<W>& get_weights() const { return weights; }
+	/// <summary>
+	/// Setter wagi krawędzi
+	/// </summary>
+	/// <param name="e">Indeks krawędzi w tablicy weights</param>
+	/// <param name="weight">Nowa waga</param>
+	void set_weight(const std::size_t e, const W weight) { weights[e] = weight; }
+	/// <summary>
+	/// Rozmiar przesunięć (część zależna od liczby wierzchołków) [B]
+	/// </summary>
+	std::size_t offset_bytes() const { return offsets.capacity() * sizeof(std::size_t); }
+	/// <summary>
+	/// Rozmiar sąsiadów i wag (część zależna od liczby krawędzi) [B]
+	/// </summary>
+	std::size_t edge_bytes() const { return targets.capacity() * sizeof(VertexIndex) + weights.capacity() * sizeof(W); }
+
+public:
+	/// <summary>
+	/// Funkcja tworząca kopię list sąsiedztwa z wagami innego typu.
+	/// Wagi mnożone są przez skalę, a dla typów całkowitych dodatkowo zaokrąglane w górę: zakodowana waga
+	/// nie jest mniejsza od przeskalowanej oryginalnej, więc heurystyka dopuszczalna dla oryginalnych wag
+	/// (np. euklidesowa razy skala) pozostaje dolnym ograniczeniem odległości na wagach całkowitych.
+	/// </summary>
+	/// <typeparam name="U">Docelowy typ wagi</typeparam>
+	/// <param name="scale">Mnożnik wag</param>
+	/// <returns>Listy sąsiedztwa z przekonwertowanymi wagami</returns>
+	template <typename U>
+	Adjacency<U> cast(const double scale = 1.0) const {
+		Adjacency<U> result;
+		result.offsets = offsets;
+		result.targets = targets;
+		result.weights.reserve(weights.size());
+		for (const W& weight : weights) {
+			const double scaled = static_cast<double>(weight) * scale;
+			if constexpr (std::is_integral_v<U>) {
+				if (scaled < 0 || scaled > static_cast<double>(std::numeric_limits<U>::max())) {
+					throw std::runtime_error("weight out of range for integer weight type");
+				}
+				// Tolerancja chroni przed zaokrągleniem w górę błędu mnożenia (np. 0.3 * 10 = 3.0000000000000004).
+				const double tolerance = 1e-9 * std::max(1.0, scaled);
+				result.weights.push_back(static_cast<U>(std::ceil(scaled - tolerance)));
+			}
+			else {
+				result.weights.push_back(static_cast<U>(scaled));
+			}
+		}
+		return result;
+	}
+
+	/// <summary>
+	/// Funkcja tworząca listy sąsiedztwa grafu z odwróconymi krawędziami (do przeszukiwania wstecz).
+	/// </summary>
+	/// <returns>Listy krawędzi wchodzących: sąsiedzi v to wierzchołki, z których prowadzi krawędź do v</returns>
+	Adjacency reversed() const {
+		Adjacency result;
+		result.offsets.assign(offsets.size(), 0);
+		result.targets.resize(targets.size());
+		result.weights.resize(weights.size());
+		for (const VertexIndex v : targets) {
+			++result.offsets[v + 1];
+		}
+		for (std::size_t v = 0; v + 1 < offsets.size(); ++v) {
+			result.offsets[v + 1] += result.offsets[v];
+		}
+		std::vector<std::size_t> next(result.offsets.begin(), result.offsets.end() - 1);
+		for (VertexIndex u = 0; u + 1 < offsets.size(); ++u) {
+			for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+				const std::size_t r = next[targets[e]]++;
+				result.targets[r] = u;
+				result.weights[r] = weights[e];
+			}
+		}
+		return result;
+	}
+
+	template <typename U>
+	friend class Adjacency;
+};
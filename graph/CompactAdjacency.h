@@ -0,0 +1,291 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Adjacency.h"
+
+/// <summary>
+/// Zwarte listy sąsiedztwa: numery sąsiadów kodowane różnicowo (varint), wagi w typie W
+/// (stałoprzecinkowe - liczba całkowita po przemnożeniu przez skalę - albo float).
+/// Sąsiedzi każdego wierzchołka są posortowani; pierwszy zapisany jest jako różnica względem numeru
+/// wierzchołka (zigzag), kolejni jako różnice względem poprzedniego, więc przy numeracji zachowującej
+/// lokalność większość sąsiadów zajmuje 1-2 bajty zamiast 4.
+/// Struktura (przesunięcia i numery sąsiadów) jest niezmienna i współdzielona przez kopie różniące się
+/// tylko wagami (np. wersje grafu dla różnych przedziałów czasu, patrz reweighted()).
+/// Udostępnia ten sam interfejs wierszy (row()) co Adjacency, więc działa z SearchKernel;
+/// numery sąsiadów dekodowane są do bufora Scratch.
+/// </summary>
+/// <typeparam name="W">Typ przechowywanej wagi (np. std::uint16_t, std::uint32_t, float).</typeparam>
+template <typename W = std::uint32_t>
+class CompactAdjacency
+{
+public:
+	using Weight = W;
+	/// <summary>
+	/// Bufor na zdekodowanych sąsiadów jednego wierzchołka
+	/// </summary>
+	struct Scratch {
+		std::vector<VertexIndex> targets;
+	};
+	using Row = typename Adjacency<W>::Row;
+
+private:
+	/// <summary>
+	/// Niezmienna struktura grafu
+	/// </summary>
+	struct Topology {
+		/// <summary>
+		/// Pierwsza krawędź wierzchołka (indeks w tablicy wag)
+		/// </summary>
+		std::vector<std::uint32_t> edge_offsets;
+		/// <summary>
+		/// Pierwszy bajt zakodowanych sąsiadów wierzchołka
+		/// </summary>
+		std::vector<std::uint32_t> byte_offsets;
+		/// <summary>
+		/// Zakodowane numery sąsiadów
+		/// </summary>
+		std::vector<std::uint8_t> ids;
+	};
+
+private:
+	std::shared_ptr<const Topology> topology;
+	std::vector<W> weights;
+	/// <summary>
+	/// Mnożnik wag przy kodowaniu (waga zakodowana = waga * scale)
+	/// </summary>
+	double scale = 1.0;
+	/// <summary>
+	/// Największy zmierzony błąd bezwzględny wagi (w jednostkach wag oryginalnych)
+	/// </summary>
+	double weight_error = 0.0;
+
+public:
+	/// <summary>
+	/// Konstruktor domyślny (graf pusty)
+	/// </summary>
+	CompactAdjacency() : topology(std::make_shared<Topology>(Topology{ { 0 }, { 0 }, {} })) {}
+	/// <summary>
+	/// Konstruktor kodujący listy sąsiedztwa
+	/// </summary>
+	/// <typeparam name="U">Typ wag list źródłowych.</typeparam>
+	/// <param name="source">Listy sąsiedztwa</param>
+	/// <param name="scale">Mnożnik wag przy konwersji do typu W (np. 10 dla wag całkowitych z dokładnością do 0.1)</param>
+	template <typename U>
+	explicit CompactAdjacency(const Adjacency<U>& source, const double scale = 1.0) :
+		scale(scale)
+	{
+		const std::size_t n = source.vertex_count();
+		if (source.edge_count() > std::numeric_limits<std::uint32_t>::max()) {
+			throw std::runtime_error("compact adjacency supports at most 2^32 - 1 edges");
+		}
+		auto encoded = std::make_shared<Topology>();
+		encoded->edge_offsets.resize(n + 1, 0);
+		encoded->byte_offsets.resize(n + 1, 0);
+		encoded->ids.reserve(source.edge_count() * 2);
+
+		std::vector<std::size_t> order;
+		for (VertexIndex v = 0; v < n; ++v) {
+			sorted_row(source, v, order);
+			VertexIndex previous = v;
+			for (std::size_t i = 0; i < order.size(); ++i) {
+				const VertexIndex target = source.get_targets()[order[i]];
+				if (i == 0) {
+					write_varint(encoded->ids, zigzag(static_cast<std::int64_t>(target) - static_cast<std::int64_t>(v)));
+				}
+				else {
+					write_varint(encoded->ids, target - previous);
+				}
+				previous = target;
+			}
+			if (encoded->ids.size() > std::numeric_limits<std::uint32_t>::max()) {
+				throw std::runtime_error("compact adjacency supports at most 4 GiB of encoded neighbour ids");
+			}
+			encoded->edge_offsets[v + 1] = static_cast<std::uint32_t>(encoded->edge_offsets[v] + order.size());
+			encoded->byte_offsets[v + 1] = static_cast<std::uint32_t>(encoded->ids.size());
+		}
+		encoded->ids.shrink_to_fit();
+		topology = std::move(encoded);
+		encode_weights(source);
+	}
+
+public:
+	/// <summary>
+	/// Liczba wierzchołków
+	/// </summary>
+	/// <returns>Liczba wierzchołków</returns>
+	std::size_t vertex_count() const { return topology->edge_offsets.size() - 1; }
+	/// <summary>
+	/// Liczba krawędzi
+	/// </summary>
+	/// <returns>Liczba krawędzi</returns>
+	std::size_t edge_count() const { return weights.size(); }
+	/// <summary>
+	/// Indeks pierwszej krawędzi wychodzącej z wierzchołka (krawędzie wierzchołka są posortowane po sąsiedzie)
+	/// </summary>
+	/// <param name="v">Wierzchołek</param>
+	/// <returns>Indeks krawędzi</returns>
+	std::size_t begin(const VertexIndex v) const { return topology->edge_offsets[v]; }
+	/// <summary>
+	/// Indeks za ostatnią krawędzią wychodzącą z wierzchołka
+	/// </summary>
+	/// <param name="v">Wierzchołek</param>
+	/// <returns>Indeks krawędzi</returns>
+	std::size_t end(const VertexIndex v) const { return topology->edge_offsets[v + 1]; }
+	/// <summary>
+	/// Stopień wyjściowy wierzchołka
+	/// </summary>
+	/// <param name="v">Wierzchołek</param>
+	/// <returns>Liczba krawędzi wychodzących</returns>
+	std::size_t degree(const VertexIndex v) const { return end(v) - begin(v); }
+	/// <summary>
+	/// Funkcja dekodująca sąsiadów wierzchołka
+	/// </summary>
+	/// <param name="v">Wierzchołek</param>
+	/// <param name="scratch">Bufor na zdekodowanych sąsiadów (ważny do następnego wywołania)</param>
+	/// <returns>Sąsiedzi i wagi krawędzi wychodzących z v</returns>
+	Row row(const VertexIndex v, Scratch& scratch) const {
+		const std::size_t count = degree(v);
+		scratch.targets.resize(count);
+		const std::uint8_t* bytes = topology->ids.data() + topology->byte_offsets[v];
+		VertexIndex previous = v;
+		for (std::size_t i = 0; i < count; ++i) {
+			const std::uint64_t value = read_varint(bytes);
+			previous = i == 0
+				? static_cast<VertexIndex>(static_cast<std::int64_t>(v) + unzigzag(value))
+				: static_cast<VertexIndex>(previous + value);
+			scratch.targets[i] = previous;
+		}
+		return Row{ scratch.targets.data(), weights.data() + begin(v), count };
+	}
+	/// <summary>
+	/// Getter tablicy wag (zakodowanych)
+	/// </summary>
+	/// <returns>Wagi krawędzi</returns>
+	const std::vector<W>& get_weights() const { return weights; }
+	/// <summary>
+	/// Setter wagi krawędzi (zakodowanej); struktura współdzielona z innymi kopiami nie jest zmieniana
+	/// </summary>
+	/// <param name="e">Indeks krawędzi</param>
+	/// <param name="weight">Nowa waga</param>
+	void set_weight(const std::size_t e, const W weight) { weights[e] = weight; }
+	/// <summary>
+	/// Mnożnik wag użyty przy kodowaniu
+	/// </summary>
+	double get_scale() const { return scale; }
+	/// <summary>
+	/// Największy błąd bezwzględny pojedynczej wagi po dekodowaniu (waga / scale) w jednostkach oryginalnych;
+	/// błąd kosztu ścieżki o k krawędziach nie przekracza k razy tej wartości.
+	/// </summary>
+	double max_weight_error() const { return weight_error; }
+	/// <summary>
+	/// Funkcja tworząca kopię o tej samej strukturze i nowych wagach (struktura jest współdzielona).
+	/// </summary>
+	/// <typeparam name="U">Typ wag list źródłowych.</typeparam>
+	/// <param name="source">Listy sąsiedztwa o tej samej strukturze i nowych wagach</param>
+	/// <returns>Zwarte listy sąsiedztwa z nowymi wagami</returns>
+	template <typename U>
+	CompactAdjacency reweighted(const Adjacency<U>& source) const {
+		if (source.vertex_count() != vertex_count() || source.edge_count() != edge_count()) {
+			throw std::runtime_error("reweighted graph must have the same structure");
+		}
+		CompactAdjacency result;
+		result.topology = topology;
+		result.scale = scale;
+		result.encode_weights(source);
+
+		Scratch scratch;
+		std::vector<std::size_t> order;
+		for (VertexIndex v = 0; v < source.vertex_count(); ++v) {
+			const Row encoded = row(v, scratch);
+			sorted_row(source, v, order);
+			for (std::size_t i = 0; i < order.size(); ++i) {
+				if (source.get_targets()[order[i]] != encoded.targets[i]) {
+					throw std::runtime_error("reweighted graph must have the same structure");
+				}
+			}
+		}
+		return result;
+	}
+	/// <summary>
+	/// Rozmiar wag [B]
+	/// </summary>
+	std::size_t weight_bytes() const { return weights.capacity() * sizeof(W); }
+	/// <summary>
+	/// Rozmiar struktury (przesunięć i zakodowanych sąsiadów) [B], współdzielonej przez kopie z reweighted()
+	/// </summary>
+	std::size_t topology_bytes() const {
+		return topology->edge_offsets.capacity() * sizeof(std::uint32_t)
+			+ topology->byte_offsets.capacity() * sizeof(std::uint32_t)
+			+ topology->ids.capacity();
+	}
+	/// <summary>
+	/// Rozmiar zakodowanych numerów sąsiadów [B]
+	/// </summary>
+	std::size_t id_bytes() const { return topology->ids.capacity(); }
+
+private:
+	template <typename U>
+	static void sorted_row(const Adjacency<U>& source, const VertexIndex v, std::vector<std::size_t>& order) {
+		order.clear();
+		for (std::size_t e = source.begin(v); e < source.end(v); ++e) {
+			order.push_back(e);
+		}
+		std::stable_sort(order.begin(), order.end(), [&](const std::size_t a, const std::size_t b) {
+			return source.get_targets()[a] < source.get_targets()[b];
+		});
+	}
+
+	template <typename U>
+	void encode_weights(const Adjacency<U>& source) {
+		const Adjacency<W> converted = source.template cast<W>(scale);
+		weights.assign(source.edge_count(), W());
+		weight_error = 0.0;
+		std::vector<std::size_t> order;
+		std::size_t position = 0;
+		for (VertexIndex v = 0; v < source.vertex_count(); ++v) {
+			sorted_row(source, v, order);
+			for (const std::size_t e : order) {
+				weights[position++] = converted.get_weights()[e];
+				const double decoded = static_cast<double>(converted.get_weights()[e]) / scale;
+				weight_error = std::max(weight_error, std::abs(decoded - static_cast<double>(source.get_weights()[e])));
+			}
+		}
+	}
+
+	static std::uint64_t zigzag(const std::int64_t value) {
+		return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+	}
+
+	static std::int64_t unzigzag(const std::uint64_t value) {
+		return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+	}
+
+	static void write_varint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+		while (value >= 0x80) {
+			out.push_back(static_cast<std::uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<std::uint8_t>(value));
+	}
+
+	static std::uint64_t read_varint(const std::uint8_t*& bytes) {
+		std::uint64_t value = 0;
+		for (unsigned int shift = 0;; shift += 7) {
+			const std::uint8_t byte = *bytes++;
+			value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+			if (byte < 0x80) {
+				return value;
+			}
+		}
+	}
+};
@@ -0,0 +1,116 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "Graph.h"
+#include "CompactAdjacency.h"
+#include "MemoryUsage.h"
+#include "../QuantizedLocalizations.h"
+
+/// <summary>
+/// Zwarta, niezmienna reprezentacja grafu do wyszukiwania: zwarte listy sąsiedztwa (CompactAdjacency),
+/// skwantowane lokalizacje (QuantizedLocalizations) i indeks osiągalności, bez obiektów wierzchołków i krawędzi.
+/// Struktura, lokalizacje i indeks osiągalności są współdzielone przez kopie utworzone przez time_slice(),
+/// więc kolejne wersje wag (np. dla przedziałów czasu) kosztują tylko sizeof(W) na krawędź.
+/// Wyszukiwanie: SearchKernel z typem wagi W na get_adjacency(), koszt w jednostkach oryginalnych to cost(...).
+/// </summary>
+/// <typeparam name="W">Typ wagi (np. std::uint32_t - stałoprzecinkowe, float).</typeparam>
+/// <typeparam name="Q">Typ skwantowanej współrzędnej.</typeparam>
+template <typename W = std::uint32_t, typename Q = std::uint16_t>
+class CompactGraph
+{
+public:
+	using Weight = W;
+
+private:
+	CompactAdjacency<W> adjacency;
+	std::shared_ptr<const QuantizedLocalizations<Q>> localizations;
+	std::shared_ptr<const Connectivity> connectivity;
+
+public:
+	/// <summary>
+	/// Konstruktor domyślny (graf pusty)
+	/// </summary>
+	CompactGraph() :
+		localizations(std::make_shared<QuantizedLocalizations<Q>>()),
+		connectivity(std::make_shared<Connectivity>())
+	{}
+	/// <summary>
+	/// Konstruktor kodujący listy sąsiedztwa i lokalizacje
+	/// </summary>
+	/// <typeparam name="U">Typ wag list źródłowych.</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa</param>
+	/// <param name="localizations">Lokalizacje wierzchołków (mogą być puste)</param>
+	/// <param name="weight_scale">Mnożnik wag przy konwersji do typu W (np. 10 dla dokładności 0.1)</param>
+	template <typename U>
+	CompactGraph(const Adjacency<U>& adjacency, const Localizations& localizations, const double weight_scale = 1.0) :
+		adjacency(adjacency, weight_scale),
+		localizations(std::make_shared<QuantizedLocalizations<Q>>(localizations)),
+		connectivity(std::make_shared<Connectivity>(adjacency))
+	{}
+	/// <summary>
+	/// Konstruktor tworzący zwartą kopię grafu
+	/// </summary>
+	/// <typeparam name="T">Typ wierzchołka grafu.</typeparam>
+	/// <param name="graph">Graf</param>
+	/// <param name="weight_scale">Mnożnik wag przy konwersji do typu W</param>
+	template <typename T>
+	explicit CompactGraph(const Graph<T>& graph, const double weight_scale = 1.0) :
+		CompactGraph(graph.get_adjacency(), graph.get_localizations(), weight_scale)
+	{}
+
+public:
+	/// <summary>
+	/// Funkcja tworząca kopię z wagami dla innego przedziału czasu; struktura, lokalizacje i indeks
+	/// osiągalności są współdzielone.
+	/// </summary>
+	/// <typeparam name="U">Typ wag list źródłowych.</typeparam>
+	/// <param name="weights">Listy sąsiedztwa o tej samej strukturze i nowych wagach</param>
+	/// <returns>Graf z nowymi wagami</returns>
+	template <typename U>
+	CompactGraph time_slice(const Adjacency<U>& weights) const {
+		CompactGraph result;
+		result.adjacency = adjacency.reweighted(weights);
+		result.localizations = localizations;
+		result.connectivity = connectivity;
+		return result;
+	}
+
+public:
+	std::size_t vertex_count() const { return adjacency.vertex_count(); }
+	std::size_t edge_count() const { return adjacency.edge_count(); }
+	const CompactAdjacency<W>& get_adjacency() const { return adjacency; }
+	const QuantizedLocalizations<Q>& get_localizations() const { return *localizations; }
+	const Connectivity& get_connectivity() const { return *connectivity; }
+	/// <summary>
+	/// Funkcja zamieniająca koszt wyznaczony na zakodowanych wagach na jednostki oryginalne
+	/// </summary>
+	/// <param name="encoded">Koszt w typie W</param>
+	/// <returns>Koszt (z błędem nie większym niż liczba krawędzi ścieżki razy max_weight_error())</returns>
+	double cost(const W encoded) const { return static_cast<double>(encoded) / adjacency.get_scale(); }
+	/// <summary>
+	/// Największy błąd bezwzględny pojedynczej wagi
+	/// </summary>
+	double max_weight_error() const { return adjacency.max_weight_error(); }
+	/// <summary>
+	/// Największy błąd położenia wierzchołka po kwantyzacji
+	/// </summary>
+	double max_localization_error() const { return localizations->error_bound(); }
+	/// <summary>
+	/// Funkcja zwracająca pamięć zajmowaną przez graf (shared_bytes - część współdzielona z kopiami z time_slice())
+	/// </summary>
+	/// <returns>Zestawienie pamięci</returns>
+	MemoryUsage memory_usage() const {
+		MemoryUsage usage;
+		usage.vertex_count = vertex_count();
+		usage.edge_count = edge_count();
+		usage.vertex_bytes = adjacency.topology_bytes() - adjacency.id_bytes() + localizations->memory_bytes();
+		usage.edge_bytes = adjacency.id_bytes() + adjacency.weight_bytes();
+		usage.index_bytes = connectivity->memory_bytes();
+		usage.shared_bytes = adjacency.topology_bytes() + localizations->memory_bytes() + connectivity->memory_bytes();
+		return usage;
+	}
+};
@@ -0,0 +1,326 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Adjacency.h"
+
+/// <summary>
+/// Raport spójności grafu.
+/// </summary>
+struct ConnectivityReport {
+	/// <summary>
+	/// Liczba silnie spójnych składowych
+	/// </summary>
+	std::size_t component_count = 0;
+	/// <summary>
+	/// Rozmiar największej silnie spójnej składowej
+	/// </summary>
+	std::size_t largest_component_size = 0;
+	/// <summary>
+	/// Wierzchołki bez krawędzi wychodzących (nie da się z nich nigdzie dojechać)
+	/// </summary>
+	std::vector<VertexIndex> dead_ends;
+	/// <summary>
+	/// Wierzchołki bez krawędzi wchodzących (nie da się do nich dojechać)
+	/// </summary>
+	std::vector<VertexIndex> unreachable;
+	/// <summary>
+	/// Wierzchołki składowych-ujść (spoza największej składowej), z których nie da się wrócić do reszty grafu
+	/// </summary>
+	std::vector<VertexIndex> sinks;
+};
+
+/// <summary>
+/// Klasa wyznaczająca silnie spójne składowe grafu (iteracyjny algorytm Tarjana) oraz indeks osiągalności
+/// na grafie składowych (DAG kondensacji). Pozwala w czasie stałym odrzucić większość par wierzchołków,
+/// między którymi nie istnieje ścieżka.
+/// Numery składowych nadawane są w kolejności zakończenia algorytmu Tarjana, więc każda krawędź DAG-u
+/// prowadzi od składowej o większym numerze do składowej o mniejszym numerze.
+/// Indeks to LABEL_COUNT etykiet przedziałowych na składową (przedział numerów postorder potomków
+/// w kolejnych przejściach DFS), więc zajmuje O(liczba składowych) pamięci niezależnie od rozmiaru grafu.
+/// </summary>
+class Connectivity
+{
+public:
+	/// <summary>
+	/// Liczba przejść DFS (etykiet przedziałowych na składową); więcej etykiet odrzuca więcej par kosztem pamięci
+	/// </summary>
+	static constexpr std::size_t LABEL_COUNT = 2;
+	/// <summary>
+	/// Maksymalna liczba składowych odwiedzanych przez reachable(), gdy etykiety nie rozstrzygają zapytania;
+	/// po jej przekroczeniu reachable() zwraca true (rozstrzyga dopiero wyszukiwanie ścieżki)
+	/// </summary>
+	static constexpr std::size_t MAX_SEARCH_COMPONENTS = 64;
+
+private:
+	/// <summary>
+	/// Etykieta przedziałowa: jeśli d jest osiągalna z c, to przedział d zawiera się w przedziale c
+	/// </summary>
+	struct Interval {
+		VertexIndex low;
+		VertexIndex post;
+	};
+
+private:
+	/// <summary>
+	/// Składowa każdego wierzchołka
+	/// </summary>
+	std::vector<VertexIndex> components;
+	/// <summary>
+	/// DAG kondensacji
+	/// </summary>
+	Adjacency<char> dag;
+	/// <summary>
+	/// Etykiety przedziałowe: labels[c * LABEL_COUNT + i] to etykieta składowej c z i-tego przejścia DFS
+	/// </summary>
+	std::vector<Interval> labels;
+	/// <summary>
+	/// Raport spójności
+	/// </summary>
+	ConnectivityReport summary;
+
+public:
+	/// <summary>
+	/// Konstruktor domyślny
+	/// </summary>
+	Connectivity() {}
+	/// <summary>
+	/// Konstruktor wyznaczający składowe i indeks osiągalności
+	/// </summary>
+	/// <typeparam name="W">Typ wagi (wagi nie są używane).</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa grafu</param>
+	template <typename W>
+	explicit Connectivity(const Adjacency<W>& adjacency) {
+		const std::size_t n = adjacency.vertex_count();
+		const auto& targets = adjacency.get_targets();
+		tarjan(adjacency);
+
+		const std::size_t count = summary.component_count;
+		std::vector<std::pair<std::pair<VertexIndex, VertexIndex>, char>> dag_edges;
+		std::vector<std::size_t> in_degree(n, 0);
+		for (VertexIndex u = 0; u < n; ++u) {
+			for (std::size_t e = adjacency.begin(u); e < adjacency.end(u); ++e) {
+				++in_degree[targets[e]];
+				if (components[u] != components[targets[e]]) {
+					dag_edges.push_back(std::make_pair(std::make_pair(components[u], components[targets[e]]), char(0)));
+				}
+			}
+		}
+		std::sort(dag_edges.begin(), dag_edges.end());
+		dag_edges.erase(std::unique(dag_edges.begin(), dag_edges.end()), dag_edges.end());
+		dag = Adjacency<char>(count, dag_edges);
+
+		label(count);
+
+		std::vector<std::size_t> sizes(count, 0);
+		for (VertexIndex v = 0; v < n; ++v) {
+			++sizes[components[v]];
+		}
+		const VertexIndex largest = count == 0 ? NO_VERTEX
+			: static_cast<VertexIndex>(std::max_element(sizes.begin(), sizes.end()) - sizes.begin());
+		summary.largest_component_size = count == 0 ? 0 : sizes[largest];
+		for (VertexIndex v = 0; v < n; ++v) {
+			if (adjacency.degree(v) == 0) {
+				summary.dead_ends.push_back(v);
+			}
+			if (in_degree[v] == 0) {
+				summary.unreachable.push_back(v);
+			}
+			if (components[v] != largest && dag.degree(components[v]) == 0 && adjacency.degree(v) != 0) {
+				summary.sinks.push_back(v);
+			}
+		}
+	}
+
+public:
+	/// <summary>
+	/// Składowa wierzchołka
+	/// </summary>
+	/// <param name="v">Wierzchołek</param>
+	/// <returns>Numer silnie spójnej składowej</returns>
+	VertexIndex component(const VertexIndex v) const { return components[v]; }
+	/// <summary>
+	/// Funkcja sprawdzająca, czy istnieje ścieżka z from do to.
+	/// </summary>
+	/// <param name="from">Wierzchołek początkowy</param>
+	/// <param name="to">Wierzchołek końcowy</param>
+	/// <returns>false, jeśli to na pewno nie jest osiągalny z from; true, jeśli jest osiągalny
+	/// lub indeks nie rozstrzygnął zapytania w MAX_SEARCH_COMPONENTS krokach</returns>
+	bool reachable(const VertexIndex from, const VertexIndex to) const {
+		const VertexIndex a = components[from];
+		const VertexIndex b = components[to];
+		if (a == b) {
+			return true;
+		}
+		if (b > a) {
+			return false;
+		}
+		if (!may_reach(a, b)) {
+			return false;
+		}
+
+		// Etykiety nie rozstrzygają - ograniczone przeszukiwanie DAG-u z odcinaniem po etykietach i numerach składowych.
+		std::array<VertexIndex, MAX_SEARCH_COMPONENTS> seen;
+		std::array<VertexIndex, MAX_SEARCH_COMPONENTS> stack;
+		std::size_t seen_count = 0;
+		std::size_t stack_size = 0;
+		seen[seen_count++] = a;
+		stack[stack_size++] = a;
+		while (stack_size > 0) {
+			const VertexIndex c = stack[--stack_size];
+			for (std::size_t e = dag.begin(c); e < dag.end(c); ++e) {
+				const VertexIndex d = dag.get_targets()[e];
+				if (d == b) {
+					return true;
+				}
+				if (d < b || !may_reach(d, b) || std::find(seen.begin(), seen.begin() + seen_count, d) != seen.begin() + seen_count) {
+					continue;
+				}
+				if (seen_count == MAX_SEARCH_COMPONENTS) {
+					return true;
+				}
+				seen[seen_count++] = d;
+				stack[stack_size++] = d;
+			}
+		}
+		return false;
+	}
+	/// <summary>
+	/// Getter raportu spójności
+	/// </summary>
+	/// <returns>Liczba składowych, ślepe zaułki, wierzchołki nieosiągalne i ujścia</returns>
+	const ConnectivityReport& report() const { return summary; }
+	/// <summary>
+	/// Rozmiar indeksu w pamięci [B]
+	/// </summary>
+	std::size_t memory_bytes() const {
+		return components.capacity() * sizeof(VertexIndex)
+			+ dag.offset_bytes() + dag.edge_bytes()
+			+ labels.capacity() * sizeof(Interval)
+			+ (summary.dead_ends.capacity() + summary.unreachable.capacity() + summary.sinks.capacity()) * sizeof(VertexIndex);
+	}
+
+private:
+	/// <summary>
+	/// Sprawdzenie etykiet: false oznacza, że b na pewno nie jest osiągalna z a
+	/// </summary>
+	bool may_reach(const VertexIndex a, const VertexIndex b) const {
+		const Interval* from = labels.data() + a * LABEL_COUNT;
+		const Interval* to = labels.data() + b * LABEL_COUNT;
+		for (std::size_t i = 0; i < LABEL_COUNT; ++i) {
+			if (to[i].low < from[i].low || to[i].post > from[i].post) {
+				return false;
+			}
+		}
+		return true;
+	}
+	/// <summary>
+	/// Funkcja wyznaczająca etykiety przedziałowe: i-te przejście DFS po DAG-u odwiedza następników
+	/// w kolejności zależnej od i, a etykieta składowej to [najmniejszy numer postorder potomka, własny numer postorder].
+	/// </summary>
+	void label(const std::size_t count) {
+		labels.assign(count * LABEL_COUNT, Interval{ 0, 0 });
+		std::vector<char> visited;
+		std::vector<std::pair<VertexIndex, std::size_t>> calls;
+		for (std::size_t i = 0; i < LABEL_COUNT; ++i) {
+			const bool reversed = i % 2 == 1;
+			visited.assign(count, 0);
+			VertexIndex post = 0;
+			// Korzenie przeglądane od największych numerów (źródeł DAG-u) - każda krawędź prowadzi w dół.
+			for (VertexIndex root = static_cast<VertexIndex>(count); root-- > 0;) {
+				if (visited[root]) {
+					continue;
+				}
+				visited[root] = 1;
+				calls.push_back(std::make_pair(root, std::size_t(0)));
+				while (!calls.empty()) {
+					const VertexIndex c = calls.back().first;
+					const std::size_t k = calls.back().second;
+					const std::size_t degree = dag.degree(c);
+					if (k < degree) {
+						++calls.back().second;
+						const VertexIndex d = dag.get_targets()[dag.begin(c) + (reversed ? degree - 1 - k : k)];
+						if (!visited[d]) {
+							visited[d] = 1;
+							calls.push_back(std::make_pair(d, std::size_t(0)));
+						}
+						continue;
+					}
+					calls.pop_back();
+					Interval& interval = labels[c * LABEL_COUNT + i];
+					interval.post = post++;
+					interval.low = interval.post;
+					for (std::size_t e = dag.begin(c); e < dag.end(c); ++e) {
+						interval.low = std::min(interval.low, labels[dag.get_targets()[e] * LABEL_COUNT + i].low);
+					}
+				}
+			}
+		}
+	}
+
+	template <typename W>
+	void tarjan(const Adjacency<W>& adjacency) {
+		const std::size_t n = adjacency.vertex_count();
+		const auto& targets = adjacency.get_targets();
+		constexpr VertexIndex UNVISITED = NO_VERTEX;
+
+		components.assign(n, NO_VERTEX);
+		std::vector<VertexIndex> index(n, UNVISITED);
+		std::vector<VertexIndex> low(n, 0);
+		std::vector<char> on_stack(n, 0);
+		std::vector<VertexIndex> stack;
+		std::vector<std::pair<VertexIndex, std::size_t>> calls;
+		VertexIndex counter = 0;
+		VertexIndex component_count = 0;
+
+		const auto visit = [&](const VertexIndex v) {
+			index[v] = low[v] = counter++;
+			stack.push_back(v);
+			on_stack[v] = 1;
+			calls.push_back(std::make_pair(v, adjacency.begin(v)));
+		};
+
+		for (VertexIndex root = 0; root < n; ++root) {
+			if (index[root] != UNVISITED) {
+				continue;
+			}
+			visit(root);
+			while (!calls.empty()) {
+				const VertexIndex v = calls.back().first;
+				const std::size_t e = calls.back().second;
+				if (e < adjacency.end(v)) {
+					++calls.back().second;
+					const VertexIndex w = targets[e];
+					if (index[w] == UNVISITED) {
+						visit(w);
+					}
+					else if (on_stack[w]) {
+						low[v] = std::min(low[v], index[w]);
+					}
+					continue;
+				}
+
+				calls.pop_back();
+				if (!calls.empty()) {
+					const VertexIndex parent = calls.back().first;
+					low[parent] = std::min(low[parent], low[v]);
+				}
+				if (low[v] == index[v]) {
+					VertexIndex w;
+					do {
+						w = stack.back();
+						stack.pop_back();
+						on_stack[w] = 0;
+						components[w] = component_count;
+					} while (w != v);
+					++component_count;
+				}
+			}
+		}
+		summary.component_count = component_count;
+	}
+};
@@ -1,14 +1,23 @@
 ﻿#pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
 #include <vector>
 #include <unordered_map>
 
 #include "Vertex.h"
 #include "Edge.h"
+#include "Adjacency.h"
+#include "Connectivity.h"
+#include "MemoryUsage.h"
+#include "../Localizations.h"
 
 /// <summary>
 /// Klasa reprezentująca graf.
 /// Graf reprezentowny jest jako zbiór wierzchołków oraz krawędzi wraz z wagami.
+/// Dodatkowo graf przechowuje zwartą, indeksowaną reprezentację (listy sąsiedztwa CSR
+/// oraz lokalizacje wierzchołków w układzie struktury tablic), z której korzystają algorytmy.
 /// </summary>
 /// <typeparam name="T">Typ wierzchołków grafu.</typeparam>
 template <typename T>
@@ -27,7 +36,36 @@ private:
 	/// <summary>
 	/// Zbiór krawędzi grafu
 	/// </summary>
-	const Edges edges;
+	Edges edges;
+	/// <summary>
+	/// Wersja grafu, zmieniana przy każdej modyfikacji wag.
+	/// Wersje są unikalne w obrębie procesu, więc identyfikują także sam graf.
+	/// </summary>
+	std::uint64_t version = next_version();
+	/// <summary>
+	/// Liczba krawędzi o ujemnej wadze
+	/// </summary>
+	std::size_t negative_weights = 0;
+	/// <summary>
+	/// Indeksy wierzchołków (pozycje w wektorze vertices)
+	/// </summary>
+	std::unordered_map<VertexSPtr<T>, VertexIndex> indices;
+	/// <summary>
+	/// Listy sąsiedztwa grafu
+	/// </summary>
+	Adjacency<Weight> adjacency;
+	/// <summary>
+	/// Silnie spójne składowe i indeks osiągalności (nie zależą od wag)
+	/// </summary>
+	Connectivity connectivity;
+	/// <summary>
+	/// Pozycje krawędzi w listach sąsiedztwa
+	/// </summary>
+	std::unordered_map<EdgeSPtr<T>, std::size_t> edge_positions;
+	/// <summary>
+	/// Lokalizacje wierzchołków (puste, jeśli dane wierzchołka nie mają lokalizacji)
+	/// </summary>
+	Localizations localizations;
 
 
 public:
@@ -43,7 +81,51 @@ public:
 	Graph(Vertices&& vertices, Edges&& edges) :
 		vertices(std::move(vertices)),
 		edges(std::move(edges))
-	{}
+	{
+		for (VertexIndex i = 0; i < this->vertices.size(); ++i) {
+			indices.insert(std::make_pair(this->vertices[i], i));
+			if constexpr (has_localization<T>::value) {
+				localizations.push_back(this->vertices[i]->get_data().get_localization());
+			}
+		}
+
+		std::vector<std::pair<std::pair<VertexIndex, VertexIndex>, Weight>> indexed_edges;
+		indexed_edges.reserve(this->edges.size());
+		for (const auto& [edge, weight] : this->edges) {
+			negative_weights += weight < 0 ? 1 : 0;
+			indexed_edges.push_back(std::make_pair(
+				std::make_pair(index_of(edge->get_from()), index_of(edge->get_to())),
+				weight
+			));
+		}
+		std::vector<std::size_t> positions;
+		adjacency = Adjacency<Weight>(this->vertices.size(), indexed_edges, &positions);
+		connectivity = Connectivity(adjacency);
+
+		std::size_t i = 0;
+		for (const auto& [edge, _] : this->edges) {
+			edge_positions.insert(std::make_pair(edge, positions[i++]));
+		}
+	}
+
+public:
+	/// <summary>
+	/// Setter wagi krawędzi. Zmienia wersję grafu, co unieważnia wyniki zapamiętane dla poprzedniej wersji.
+	/// Nie może być wywoływany współbieżnie z wyszukiwaniem na tym grafie.
+	/// </summary>
+	/// <param name="edge">Krawędź grafu</param>
+	/// <param name="weight">Nowa waga</param>
+	void set_weight(const EdgeSPtr<T>& edge, const Weight weight) {
+		const auto it = edges.find(edge);
+		if (it == edges.end()) {
+			throw std::runtime_error("edge not found in graph");
+		}
+		negative_weights -= it->second < 0 ? 1 : 0;
+		negative_weights += weight < 0 ? 1 : 0;
+		it->second = weight;
+		adjacency.set_weight(edge_positions.at(edge), weight);
+		version = next_version();
+	}
 
 public:
 	/// <summary>
@@ -56,4 +138,80 @@ public:
 	/// </summary>
 	/// <returns>Krawędzie grafu</returns>
 	const Edges& get_edges() const { return edges; };
-};
\ No newline at end of file
+	/// <summary>
+	/// Getter list sąsiedztwa grafu
+	/// </summary>
+	/// <returns>Listy sąsiedztwa w formacie CSR</returns>
+	const Adjacency<Weight>& get_adjacency() const { return adjacency; }
+	/// <summary>
+	/// Getter informacji o spójności grafu
+	/// </summary>
+	/// <returns>Silnie spójne składowe i indeks osiągalności</returns>
+	const Connectivity& get_connectivity() const { return connectivity; }
+	/// <summary>
+	/// Getter lokalizacji wierzchołków
+	/// </summary>
+	/// <returns>Lokalizacje wierzchołków w kolejności indeksów</returns>
+	const Localizations& get_localizations() const { return localizations; }
+	/// <summary>
+	/// Getter wersji grafu
+	/// </summary>
+	/// <returns>Wersja grafu</returns>
+	std::uint64_t get_version() const { return version; }
+	/// <summary>
+	/// Czy graf ma krawędzie o ujemnej wadze
+	/// </summary>
+	/// <returns>true, jeśli choć jedna waga jest ujemna</returns>
+	bool has_negative_weights() const { return negative_weights != 0; }
+	/// <summary>
+	/// Funkcja szacująca pamięć zajmowaną przez graf: obiekty wierzchołków i krawędzi wraz z blokami
+	/// kontrolnymi std::shared_ptr, węzły map (wskaźnik następnika i zapamiętany skrót), listy sąsiedztwa,
+	/// lokalizacje oraz indeks osiągalności. Narzut alokatora przyjmowany jest jako HEAP_OVERHEAD na alokację.
+	/// </summary>
+	/// <returns>Zestawienie pamięci</returns>
+	MemoryUsage memory_usage() const {
+		constexpr std::size_t HEAP_OVERHEAD = 16;
+		constexpr std::size_t CONTROL_BLOCK = 3 * sizeof(void*);
+		constexpr std::size_t NODE_LINKS = 2 * sizeof(void*);
+		const auto shared_object = [&](const std::size_t size) { return size + HEAP_OVERHEAD + CONTROL_BLOCK + HEAP_OVERHEAD; };
+		const auto map_node = [&](const std::size_t value) { return value + NODE_LINKS + HEAP_OVERHEAD; };
+
+		MemoryUsage usage;
+		usage.vertex_count = vertices.size();
+		usage.edge_count = edges.size();
+		usage.vertex_bytes = vertices.capacity() * sizeof(VertexSPtr<T>)
+			+ vertices.size() * (shared_object(sizeof(Vertex<T>)) + map_node(sizeof(std::pair<const VertexSPtr<T>, VertexIndex>)))
+			+ indices.bucket_count() * sizeof(void*)
+			+ adjacency.offset_bytes()
+			+ localizations.memory_bytes();
+		usage.edge_bytes = edges.size() * (shared_object(sizeof(Edge<T>))
+				+ map_node(sizeof(std::pair<const EdgeSPtr<T>, Weight>))
+				+ map_node(sizeof(std::pair<const EdgeSPtr<T>, std::size_t>)))
+			+ (edges.bucket_count() + edge_positions.bucket_count()) * sizeof(void*)
+			+ adjacency.edge_bytes();
+		usage.index_bytes = connectivity.memory_bytes();
+		return usage;
+	}
+	/// <summary>
+	/// Funkcja zwracająca indeks wierzchołka
+	/// </summary>
+	/// <param name="vertex">Wierzchołek grafu</param>
+	/// <returns>Indeks wierzchołka</returns>
+	VertexIndex index_of(const VertexSPtr<T>& vertex) const {
+		const auto it = indices.find(vertex);
+		if (it == indices.cend()) {
+			throw std::runtime_error("vertex not found in graph");
+		}
+		return it->second;
+	}
+
+private:
+	/// <summary>
+	/// Funkcja zwracająca kolejny, unikalny w obrębie procesu numer wersji grafu
+	/// </summary>
+	/// <returns>Numer wersji</returns>
+	static std::uint64_t next_version() {
+		static std::atomic<std::uint64_t> counter{ 0 };
+		return ++counter;
+	}
+};
@@ -0,0 +1,58 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <ostream>
+
+/// <summary>
+/// Zestawienie pamięci zajmowanej przez graf, z podziałem na część zależną od liczby wierzchołków,
+/// część zależną od liczby krawędzi oraz indeksy pochodne (np. indeks osiągalności).
+/// </summary>
+struct MemoryUsage {
+	std::size_t vertex_count = 0;
+	std::size_t edge_count = 0;
+	/// <summary>
+	/// Dane wierzchołków: obiekty wierzchołków, lokalizacje, przesunięcia list sąsiedztwa, mapy indeksów [B]
+	/// </summary>
+	std::size_t vertex_bytes = 0;
+	/// <summary>
+	/// Dane krawędzi: obiekty krawędzi, mapy krawędzi, sąsiedzi i wagi [B]
+	/// </summary>
+	std::size_t edge_bytes = 0;
+	/// <summary>
+	/// Indeksy pochodne [B]
+	/// </summary>
+	std::size_t index_bytes = 0;
+	/// <summary>
+	/// Część powyższych danych współdzielona z innymi kopiami grafu (np. struktura wspólna dla przedziałów czasu) [B]
+	/// </summary>
+	std::size_t shared_bytes = 0;
+
+	/// <summary>
+	/// Łączny rozmiar [B]
+	/// </summary>
+	std::size_t total_bytes() const { return vertex_bytes + edge_bytes + index_bytes; }
+	/// <summary>
+	/// Bajty na wierzchołek (tylko dane wierzchołków)
+	/// </summary>
+	double bytes_per_vertex() const {
+		return vertex_count == 0 ? 0.0 : static_cast<double>(vertex_bytes) / static_cast<double>(vertex_count);
+	}
+	/// <summary>
+	/// Bajty na krawędź (tylko dane krawędzi)
+	/// </summary>
+	double bytes_per_edge() const {
+		return edge_count == 0 ? 0.0 : static_cast<double>(edge_bytes) / static_cast<double>(edge_count);
+	}
+};
+
+/// <summary>
+/// Operator wypisujący zestawienie pamięci w jednej linii
+/// </summary>
+inline std::ostream& operator<<(std::ostream& out, const MemoryUsage& usage) {
+	return out << usage.vertex_count << " vertices, " << usage.edge_count << " edges: "
+		<< usage.total_bytes() << " B total, "
+		<< usage.bytes_per_vertex() << " B/vertex, "
+		<< usage.bytes_per_edge() << " B/edge, "
+		<< usage.index_bytes << " B indices, "
+		<< usage.shared_bytes << " B shared";
+}
@@ -0,0 +1,685 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../graph/Adjacency.h"
+#include "../simd/Intersection.h"
+
+/// <summary>
+/// Statystyki indeksu etykiet hubów.
+/// </summary>
+struct HubLabelStats {
+	std::size_t vertex_count = 0;
+	/// <summary>
+	/// Łączna liczba wpisów w etykietach (w przód i wstecz, bez dopełnienia)
+	/// </summary>
+	std::size_t label_entries = 0;
+	/// <summary>
+	/// Średni rozmiar pojedynczej etykiety (w przód lub wstecz), porównywalny z max_label_size
+	/// </summary>
+	double mean_label_size = 0;
+	/// <summary>
+	/// Największy rozmiar pojedynczej etykiety
+	/// </summary>
+	std::size_t max_label_size = 0;
+	/// <summary>
+	/// Rozmiar indeksu w pamięci [B]
+	/// </summary>
+	std::size_t bytes = 0;
+	/// <summary>
+	/// Czas budowy [ms] (0 dla indeksu wczytanego z pliku)
+	/// </summary>
+	double build_ms = 0;
+	/// <summary>
+	/// Liczba wątków budowy
+	/// </summary>
+	unsigned int threads = 0;
+	/// <summary>
+	/// Liczba paczek hubów przetwarzanych równolegle
+	/// </summary>
+	std::size_t batches = 0;
+};
+
+/// <summary>
+/// Indeks etykiet hubów (2-hop labeling) do zapytań o odległość bez przeszukiwania grafu.
+/// Każdy wierzchołek v ma etykietę w przód (huby h osiągalne z v wraz z d(v, h)) oraz etykietę wstecz
+/// (huby h, z których osiągalny jest v, wraz z d(h, v)); d(s, t) = min po wspólnych hubach d(s, h) + d(h, t).
+/// Etykiety wyznaczane są metodą pruned landmark labeling: huby przetwarzane są w kolejności ważności
+/// (domyślnie malejący stopień), a przeszukanie z huba jest obcinane w wierzchołkach, dla których
+/// odległość pokrywają już wcześniejsze huby. Przy wielu wątkach huby przetwarzane są paczkami -
+/// w obrębie paczki przeszukania korzystają tylko z etykiet poprzednich paczek (etykiety są wtedy
+/// nieco większe, ale nadal poprawne).
+/// Etykiety przechowywane są jako struktura tablic (numery hubów i odległości osobno), posortowane
+/// po numerze huba i dopełnione do wielokrotności 4, co pozwala na wektorowe przecięcie (simd::min_plus_intersection).
+/// Opcjonalne wskaźniki rodziców pozwalają odtworzyć ścieżkę.
+/// </summary>
+class HubLabels
+{
+public:
+	/// <summary>
+	/// Wartownik dopełniający etykiety w przód
+	/// </summary>
+	static constexpr std::uint32_t FORWARD_SENTINEL = NO_VERTEX;
+	/// <summary>
+	/// Wartownik dopełniający etykiety wstecz (różny od FORWARD_SENTINEL, by wartowniki się nie przecinały)
+	/// </summary>
+	static constexpr std::uint32_t BACKWARD_SENTINEL = NO_VERTEX - 1;
+
+	/// <summary>
+	/// Widok etykiety jednego wierzchołka: pary (hubs[i], distances[i])
+	/// </summary>
+	struct LabelView {
+		const std::uint32_t* hubs;
+		const double* distances;
+		std::size_t size;
+	};
+
+private:
+	static constexpr double INF = std::numeric_limits<double>::infinity();
+	static constexpr char MAGIC[8] = { 'Z', 'T', 'M', 'H', 'U', 'B', 'L', 'B' };
+	static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+	/// <summary>
+	/// Etykiety jednego kierunku: etykieta wierzchołka v zajmuje zakres [offsets[v], offsets[v + 1])
+	/// (z dopełnieniem), z czego pierwsze sizes[v] wpisów to prawdziwe huby.
+	/// </summary>
+	struct Labels {
+		std::vector<std::size_t> offsets;
+		std::vector<std::uint32_t> sizes;
+		/// <summary>
+		/// Numery hubów (pozycje w kolejności ważności)
+		/// </summary>
+		std::vector<std::uint32_t> hubs;
+		std::vector<double> distances;
+		/// <summary>
+		/// Następny wierzchołek na ścieżce do huba (w przód) lub poprzedni na ścieżce od huba (wstecz)
+		/// </summary>
+		std::vector<VertexIndex> parents;
+	};
+
+	struct BuildEntry {
+		std::uint32_t hub;
+		double distance;
+		VertexIndex parent;
+	};
+	using BuildLabels = std::vector<std::vector<BuildEntry>>;
+	using Found = std::vector<std::pair<VertexIndex, BuildEntry>>;
+
+	/// <summary>
+	/// Obszar roboczy przeszukania z jednego huba
+	/// </summary>
+	struct Workspace {
+		std::vector<double> dist;
+		std::vector<VertexIndex> parent;
+		std::vector<VertexIndex> touched;
+		/// <summary>
+		/// Odległości do hubów z etykiety bieżącego huba, indeksowane numerem huba
+		/// </summary>
+		std::vector<double> hub_dist;
+
+		explicit Workspace(const std::size_t n = 0) : dist(n, INF), parent(n, NO_VERTEX), hub_dist(n, INF) {}
+	};
+
+	/// <summary>
+	/// Wyniki przeszukań jednego huba: wpisy etykiet wstecz i w przód
+	/// </summary>
+	struct HubResult {
+		Found backward;
+		Found forward;
+	};
+
+private:
+	/// <summary>
+	/// Wierzchołki w kolejności ważności: order[h] to wierzchołek huba h
+	/// </summary>
+	std::vector<VertexIndex> order;
+	Labels forward;
+	Labels backward;
+	std::size_t edge_count = 0;
+	std::uint64_t graph_fingerprint = 0;
+	HubLabelStats stats;
+
+public:
+	/// <summary>
+	/// Konstruktor domyślny
+	/// </summary>
+	HubLabels() {}
+	/// <summary>
+	/// Konstruktor budujący etykiety w domyślnej kolejności (malejący stopień wierzchołka)
+	/// </summary>
+	/// <typeparam name="W">Typ wagi.</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa grafu</param>
+	/// <param name="threads">Liczba wątków budowy (0 - liczba rdzeni)</param>
+	/// <param name="with_paths">Czy zapamiętać wskaźniki rodziców (odtwarzanie ścieżek)</param>
+	template <typename W>
+	explicit HubLabels(const Adjacency<W>& adjacency, const unsigned int threads = 0, const bool with_paths = true) :
+		HubLabels(adjacency, degree_order(adjacency), threads, with_paths)
+	{}
+	/// <summary>
+	/// Konstruktor budujący etykiety w zadanej kolejności ważności wierzchołków
+	/// </summary>
+	/// <typeparam name="W">Typ wagi.</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa grafu</param>
+	/// <param name="order">Permutacja wierzchołków od najważniejszego</param>
+	/// <param name="threads">Liczba wątków budowy (0 - liczba rdzeni)</param>
+	/// <param name="with_paths">Czy zapamiętać wskaźniki rodziców (odtwarzanie ścieżek)</param>
+	template <typename W>
+	HubLabels(
+		const Adjacency<W>& adjacency,
+		std::vector<VertexIndex> order,
+		const unsigned int threads = 0,
+		const bool with_paths = true
+	) :
+		order(std::move(order)),
+		edge_count(adjacency.edge_count()),
+		graph_fingerprint(fingerprint(adjacency))
+	{
+		if (!is_permutation(this->order, adjacency.vertex_count())) {
+			throw std::runtime_error("hub order must be a permutation of the vertices");
+		}
+		build(adjacency, threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency()), with_paths);
+	}
+
+public:
+	/// <summary>
+	/// Funkcja zwracająca odległość z s do t (przecięcie etykiety w przód s z etykietą wstecz t).
+	/// </summary>
+	/// <param name="s">Wierzchołek początkowy</param>
+	/// <param name="t">Wierzchołek końcowy</param>
+	/// <returns>Odległość, lub +inf jeśli t nie jest osiągalny z s</returns>
+	double distance(const VertexIndex s, const VertexIndex t) const {
+		const std::size_t fs = forward.offsets[s];
+		const std::size_t bt = backward.offsets[t];
+		return simd::min_plus_intersection(
+			forward.hubs.data() + fs, forward.distances.data() + fs, forward.offsets[s + 1] - fs,
+			backward.hubs.data() + bt, backward.distances.data() + bt, backward.offsets[t + 1] - bt
+		);
+	}
+	/// <summary>
+	/// Funkcja odtwarzająca najkrótszą ścieżkę z s do t (wymaga indeksu zbudowanego z wskaźnikami rodziców).
+	/// </summary>
+	/// <param name="s">Wierzchołek początkowy</param>
+	/// <param name="t">Wierzchołek końcowy</param>
+	/// <returns>Kolejne wierzchołki ścieżki, lub pusty wektor jeśli t nie jest osiągalny z s</returns>
+	std::vector<VertexIndex> path(const VertexIndex s, const VertexIndex t) const {
+		if (!has_paths()) {
+			throw std::runtime_error("hub labels were built without parent pointers");
+		}
+		const std::uint32_t hub = best_hub(s, t);
+		if (hub == FORWARD_SENTINEL) {
+			return {};
+		}
+		const VertexIndex h = order[hub];
+		std::vector<VertexIndex> result{ s };
+		for (VertexIndex v = s; v != h;) {
+			v = forward.parents[entry(forward, v, hub)];
+			result.push_back(v);
+		}
+		const std::size_t middle = result.size();
+		for (VertexIndex v = t; v != h;) {
+			result.push_back(v);
+			v = backward.parents[entry(backward, v, hub)];
+		}
+		std::reverse(result.begin() + middle, result.end());
+		return result;
+	}
+	/// <summary>
+	/// Widok etykiety w przód wierzchołka (bez dopełnienia); huby to pozycje w kolejności ważności (0..vertex_count()-1)
+	/// </summary>
+	/// <param name="v">Wierzchołek</param>
+	LabelView forward_label(const VertexIndex v) const { return view(forward, v); }
+	/// <summary>
+	/// Widok etykiety wstecz wierzchołka (bez dopełnienia)
+	/// </summary>
+	/// <param name="v">Wierzchołek</param>
+	LabelView backward_label(const VertexIndex v) const { return view(backward, v); }
+	/// <summary>
+	/// Czy indeks pozwala odtwarzać ścieżki
+	/// </summary>
+	bool has_paths() const { return !forward.parents.empty() || order.empty(); }
+	/// <summary>
+	/// Liczba wierzchołków
+	/// </summary>
+	std::size_t vertex_count() const { return order.size(); }
+	/// <summary>
+	/// Getter statystyk indeksu
+	/// </summary>
+	const HubLabelStats& get_stats() const { return stats; }
+	/// <summary>
+	/// Funkcja sprawdzająca, czy indeks został zbudowany dla grafu o tej samej strukturze i wagach
+	/// </summary>
+	/// <typeparam name="W">Typ wagi.</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa grafu</param>
+	template <typename W>
+	bool matches(const Adjacency<W>& adjacency) const {
+		return adjacency.vertex_count() == order.size()
+			&& adjacency.edge_count() == edge_count
+			&& fingerprint(adjacency) == graph_fingerprint;
+	}
+
+	/// <summary>
+	/// Funkcja zapisująca indeks w formacie binarnym (kolejność bajtów maszyny, która go zapisała).
+	/// </summary>
+	/// <param name="out">Strumień binarny</param>
+	void save(std::ostream& out) const {
+		out.write(MAGIC, sizeof(MAGIC));
+		write_value(out, FORMAT_VERSION);
+		write_value(out, static_cast<std::uint64_t>(order.size()));
+		write_value(out, static_cast<std::uint64_t>(edge_count));
+		write_value(out, graph_fingerprint);
+		write_vector(out, order);
+		for (const Labels* labels : { &forward, &backward }) {
+			std::vector<std::uint64_t> offsets(labels->offsets.begin(), labels->offsets.end());
+			write_vector(out, offsets);
+			write_vector(out, labels->sizes);
+			write_vector(out, labels->hubs);
+			write_vector(out, labels->distances);
+			write_vector(out, labels->parents);
+		}
+		if (!out) {
+			throw std::runtime_error("cannot write hub labels");
+		}
+	}
+	/// <summary>
+	/// Funkcja wczytująca indeks zapisany przez save() i sprawdzająca, czy pasuje do grafu.
+	/// </summary>
+	/// <typeparam name="W">Typ wagi.</typeparam>
+	/// <param name="in">Strumień binarny</param>
+	/// <param name="adjacency">Listy sąsiedztwa grafu, dla którego indeks ma być użyty</param>
+	/// <returns>Wczytany indeks</returns>
+	template <typename W>
+	static HubLabels load(std::istream& in, const Adjacency<W>& adjacency) {
+		char magic[sizeof(MAGIC)] = {};
+		in.read(magic, sizeof(magic));
+		if (!in || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+			throw std::runtime_error("not a hub label file");
+		}
+		if (read_value<std::uint32_t>(in) != FORMAT_VERSION) {
+			throw std::runtime_error("unsupported hub label file version");
+		}
+
+		HubLabels labels;
+		const std::uint64_t n = read_value<std::uint64_t>(in);
+		labels.edge_count = static_cast<std::size_t>(read_value<std::uint64_t>(in));
+		labels.graph_fingerprint = read_value<std::uint64_t>(in);
+		if (n != adjacency.vertex_count() || labels.edge_count != adjacency.edge_count()
+			|| labels.graph_fingerprint != fingerprint(adjacency)) {
+			throw std::runtime_error("hub label file was built for a different graph");
+		}
+		labels.order = read_vector<VertexIndex>(in);
+		for (Labels* direction : { &labels.forward, &labels.backward }) {
+			const auto offsets = read_vector<std::uint64_t>(in);
+			direction->offsets.assign(offsets.begin(), offsets.end());
+			direction->sizes = read_vector<std::uint32_t>(in);
+			direction->hubs = read_vector<std::uint32_t>(in);
+			direction->distances = read_vector<double>(in);
+			direction->parents = read_vector<VertexIndex>(in);
+			if (!valid(*direction, static_cast<std::size_t>(n))) {
+				throw std::runtime_error("hub label file is corrupted");
+			}
+		}
+		if (!is_permutation(labels.order, static_cast<std::size_t>(n))
+			|| labels.forward.parents.empty() != labels.backward.parents.empty()) {
+			throw std::runtime_error("hub label file is corrupted");
+		}
+		labels.update_stats();
+		return labels;
+	}
+	/// <summary>
+	/// Domyślna kolejność ważności: malejąca suma stopni wejściowego i wyjściowego
+	/// </summary>
+	/// <typeparam name="W">Typ wagi.</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa grafu</param>
+	template <typename W>
+	static std::vector<VertexIndex> degree_order(const Adjacency<W>& adjacency) {
+		const std::size_t n = adjacency.vertex_count();
+		std::vector<std::size_t> degree(n, 0);
+		for (VertexIndex u = 0; u < n; ++u) {
+			degree[u] += adjacency.degree(u);
+			for (std::size_t e = adjacency.begin(u); e < adjacency.end(u); ++e) {
+				++degree[adjacency.get_targets()[e]];
+			}
+		}
+		std::vector<VertexIndex> result(n);
+		for (VertexIndex v = 0; v < n; ++v) {
+			result[v] = v;
+		}
+		std::stable_sort(result.begin(), result.end(), [&](const VertexIndex a, const VertexIndex b) {
+			return degree[a] > degree[b];
+		});
+		return result;
+	}
+	/// <summary>
+	/// Skrót struktury i wag grafu (FNV-1a), zapisywany razem z indeksem
+	/// </summary>
+	/// <typeparam name="W">Typ wagi.</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa grafu</param>
+	template <typename W>
+	static std::uint64_t fingerprint(const Adjacency<W>& adjacency) {
+		std::uint64_t hash = 14695981039346656037ull;
+		const auto mix = [&hash](const void* data, const std::size_t size) {
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			for (std::size_t i = 0; i < size; ++i) {
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+		};
+		for (VertexIndex u = 0; u < adjacency.vertex_count(); ++u) {
+			const std::uint64_t degree = adjacency.degree(u);
+			mix(&degree, sizeof(degree));
+			for (std::size_t e = adjacency.begin(u); e < adjacency.end(u); ++e) {
+				const VertexIndex v = adjacency.get_targets()[e];
+				const double w = static_cast<double>(adjacency.get_weights()[e]);
+				mix(&v, sizeof(v));
+				mix(&w, sizeof(w));
+			}
+		}
+		return hash;
+	}
+
+private:
+	template <typename W>
+	void build(const Adjacency<W>& adjacency, const unsigned int threads, const bool with_paths) {
+		const auto started = std::chrono::steady_clock::now();
+		const std::size_t n = adjacency.vertex_count();
+
+		const Adjacency<W> reversed = adjacency.reversed();
+
+		BuildLabels forward_build(n);
+		BuildLabels backward_build(n);
+		std::vector<Workspace> workspaces;
+		for (unsigned int t = 0; t < threads; ++t) {
+			workspaces.emplace_back(n);
+		}
+
+		std::size_t batches = 0;
+		std::vector<HubResult> results;
+		for (std::size_t first = 0; first < n; ++batches) {
+			// Pierwsze huby pokrywają najwięcej par, więc paczki rosną dopiero, gdy etykiety są już dobrze wypełnione.
+			const std::size_t batch = threads == 1 ? 1 : std::max<std::size_t>(threads, first / 32);
+			const std::size_t count = std::min(batch, n - first);
+			results.assign(count, HubResult());
+
+			std::atomic<std::size_t> next{ 0 };
+			const auto worker = [&](Workspace& workspace) {
+				for (std::size_t i = next++; i < count; i = next++) {
+					const std::uint32_t hub = static_cast<std::uint32_t>(first + i);
+					pruned_search(adjacency, hub, forward_build, backward_build, workspace, results[i].backward);
+					pruned_search(reversed, hub, backward_build, forward_build, workspace, results[i].forward);
+				}
+			};
+			std::vector<std::thread> pool;
+			const unsigned int workers = static_cast<unsigned int>(std::min<std::size_t>(threads, count));
+			for (unsigned int t = 1; t < workers; ++t) {
+				pool.emplace_back(worker, std::ref(workspaces[t]));
+			}
+			worker(workspaces[0]);
+			for (auto& thread : pool) {
+				thread.join();
+			}
+
+			// Huby dopisywane są w kolejności numerów, więc etykiety pozostają posortowane.
+			for (const auto& result : results) {
+				for (const auto& [v, entry] : result.backward) {
+					backward_build[v].push_back(entry);
+				}
+				for (const auto& [v, entry] : result.forward) {
+					forward_build[v].push_back(entry);
+				}
+			}
+			first += count;
+		}
+
+		compact(forward_build, forward, FORWARD_SENTINEL, with_paths);
+		compact(backward_build, backward, BACKWARD_SENTINEL, with_paths);
+		update_stats();
+		stats.build_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+		stats.threads = threads;
+		stats.batches = batches;
+	}
+
+	/// <summary>
+	/// Przeszukanie Dijkstry z huba obcinane w wierzchołkach, których odległość od huba pokrywają już etykiety.
+	/// Dla grafu oryginalnego wyznacza wpisy etykiet wstecz (d(h, v)), dla odwróconego - etykiet w przód (d(v, h)).
+	/// </summary>
+	/// <param name="graph">Graf (oryginalny lub odwrócony)</param>
+	/// <param name="hub">Numer huba</param>
+	/// <param name="source_labels">Etykiety, z których brana jest etykieta huba</param>
+	/// <param name="target_labels">Etykiety, z których brane są etykiety odwiedzanych wierzchołków</param>
+	/// <param name="workspace">Obszar roboczy</param>
+	/// <param name="found">Nowe wpisy etykiet (wierzchołek, wpis)</param>
+	template <typename W>
+	void pruned_search(
+		const Adjacency<W>& graph,
+		const std::uint32_t hub,
+		const BuildLabels& source_labels,
+		const BuildLabels& target_labels,
+		Workspace& workspace,
+		Found& found
+	) const {
+		using Item = std::pair<double, VertexIndex>;
+		std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+		const VertexIndex h = order[hub];
+
+		for (const auto& entry : source_labels[h]) {
+			workspace.hub_dist[entry.hub] = entry.distance;
+		}
+		workspace.dist[h] = 0;
+		workspace.parent[h] = NO_VERTEX;
+		workspace.touched.push_back(h);
+		heap.push(Item(0.0, h));
+		while (!heap.empty()) {
+			const auto [d, v] = heap.top();
+			heap.pop();
+			if (d > workspace.dist[v]) {
+				continue;
+			}
+
+			double covered = INF;
+			for (const auto& entry : target_labels[v]) {
+				covered = std::min(covered, workspace.hub_dist[entry.hub] + entry.distance);
+			}
+			if (covered <= d) {
+				continue;
+			}
+			found.push_back(std::make_pair(v, BuildEntry{ hub, d, workspace.parent[v] }));
+
+			for (std::size_t e = graph.begin(v); e < graph.end(v); ++e) {
+				const VertexIndex w = graph.get_targets()[e];
+				const double candidate = d + static_cast<double>(graph.get_weights()[e]);
+				if (candidate < workspace.dist[w]) {
+					if (workspace.dist[w] == INF) {
+						workspace.touched.push_back(w);
+					}
+					workspace.dist[w] = candidate;
+					workspace.parent[w] = v;
+					heap.push(Item(candidate, w));
+				}
+			}
+		}
+
+		for (const VertexIndex v : workspace.touched) {
+			workspace.dist[v] = INF;
+			workspace.parent[v] = NO_VERTEX;
+		}
+		workspace.touched.clear();
+		for (const auto& entry : source_labels[h]) {
+			workspace.hub_dist[entry.hub] = INF;
+		}
+	}
+
+	static void compact(BuildLabels& build, Labels& labels, const std::uint32_t sentinel, const bool with_paths) {
+		const std::size_t n = build.size();
+		labels.offsets.assign(n + 1, 0);
+		labels.sizes.assign(n, 0);
+		for (std::size_t v = 0; v < n; ++v) {
+			labels.sizes[v] = static_cast<std::uint32_t>(build[v].size());
+			labels.offsets[v + 1] = labels.offsets[v] + (build[v].size() + 3) / 4 * 4;
+		}
+		labels.hubs.assign(labels.offsets[n], sentinel);
+		labels.distances.assign(labels.offsets[n], INF);
+		labels.parents.assign(with_paths ? labels.offsets[n] : 0, NO_VERTEX);
+		for (std::size_t v = 0; v < n; ++v) {
+			for (std::size_t i = 0; i < build[v].size(); ++i) {
+				const std::size_t position = labels.offsets[v] + i;
+				labels.hubs[position] = build[v][i].hub;
+				labels.distances[position] = build[v][i].distance;
+				if (with_paths) {
+					labels.parents[position] = build[v][i].parent;
+				}
+			}
+			std::vector<BuildEntry>().swap(build[v]);
+		}
+	}
+
+	void update_stats() {
+		stats = HubLabelStats();
+		stats.vertex_count = order.size();
+		for (const Labels* labels : { &forward, &backward }) {
+			for (const std::uint32_t size : labels->sizes) {
+				stats.label_entries += size;
+				stats.max_label_size = std::max<std::size_t>(stats.max_label_size, size);
+			}
+			stats.bytes += labels->offsets.size() * sizeof(std::size_t)
+				+ labels->sizes.size() * sizeof(std::uint32_t)
+				+ labels->hubs.size() * sizeof(std::uint32_t)
+				+ labels->distances.size() * sizeof(double)
+				+ labels->parents.size() * sizeof(VertexIndex);
+		}
+		stats.bytes += order.size() * sizeof(VertexIndex);
+		stats.mean_label_size = order.empty() ? 0.0 : static_cast<double>(stats.label_entries) / static_cast<double>(2 * order.size());
+	}
+
+	/// <summary>
+	/// Hub realizujący najkrótszą ścieżkę z s do t (FORWARD_SENTINEL, jeśli nie ma wspólnego huba)
+	/// </summary>
+	std::uint32_t best_hub(const VertexIndex s, const VertexIndex t) const {
+		std::size_t i = forward.offsets[s];
+		std::size_t j = backward.offsets[t];
+		const std::size_t i_end = i + forward.sizes[s];
+		const std::size_t j_end = j + backward.sizes[t];
+		double best = INF;
+		std::uint32_t hub = FORWARD_SENTINEL;
+		while (i < i_end && j < j_end) {
+			if (forward.hubs[i] == backward.hubs[j]) {
+				const double sum = forward.distances[i] + backward.distances[j];
+				if (sum < best) {
+					best = sum;
+					hub = forward.hubs[i];
+				}
+				++i;
+				++j;
+			}
+			else if (forward.hubs[i] < backward.hubs[j]) {
+				++i;
+			}
+			else {
+				++j;
+			}
+		}
+		return hub;
+	}
+
+	static LabelView view(const Labels& labels, const VertexIndex v) {
+		const std::size_t first = labels.offsets[v];
+		return LabelView{ labels.hubs.data() + first, labels.distances.data() + first, labels.sizes[v] };
+	}
+
+	static std::size_t entry(const Labels& labels, const VertexIndex v, const std::uint32_t hub) {
+		const auto first = labels.hubs.begin() + static_cast<std::ptrdiff_t>(labels.offsets[v]);
+		const auto last = first + labels.sizes[v];
+		const auto it = std::lower_bound(first, last, hub);
+		if (it == last || *it != hub) {
+			throw std::runtime_error("hub label is missing a path entry");
+		}
+		return static_cast<std::size_t>(it - labels.hubs.begin());
+	}
+
+	static bool is_permutation(const std::vector<VertexIndex>& order, const std::size_t n) {
+		if (order.size() != n) {
+			return false;
+		}
+		std::vector<char> seen(n, 0);
+		for (const VertexIndex v : order) {
+			if (v >= n || seen[v]) {
+				return false;
+			}
+			seen[v] = 1;
+		}
+		return true;
+	}
+
+	static bool valid(const Labels& labels, const std::size_t n) {
+		if (labels.offsets.size() != n + 1 || labels.sizes.size() != n || labels.offsets.front() != 0
+			|| labels.offsets.back() != labels.hubs.size() || labels.distances.size() != labels.hubs.size()
+			|| (!labels.parents.empty() && labels.parents.size() != labels.hubs.size())) {
+			return false;
+		}
+		for (std::size_t v = 0; v < n; ++v) {
+			const std::size_t length = labels.offsets[v + 1] - labels.offsets[v];
+			if (labels.offsets[v + 1] < labels.offsets[v] || length % 4 != 0 || labels.sizes[v] > length) {
+				return false;
+			}
+			for (std::size_t i = labels.offsets[v]; i < labels.offsets[v] + labels.sizes[v]; ++i) {
+				const bool sorted = i == labels.offsets[v] || labels.hubs[i - 1] < labels.hubs[i];
+				const bool parent_ok = labels.parents.empty() || labels.parents[i] == NO_VERTEX || labels.parents[i] < n;
+				if (labels.hubs[i] >= n || !sorted || !parent_ok) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	template <typename V>
+	static void write_value(std::ostream& out, const V& value) {
+		out.write(reinterpret_cast<const char*>(&value), sizeof(V));
+	}
+
+	template <typename V>
+	static void write_vector(std::ostream& out, const std::vector<V>& values) {
+		write_value(out, static_cast<std::uint64_t>(values.size()));
+		out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(V)));
+	}
+
+	template <typename V>
+	static V read_value(std::istream& in) {
+		V value{};
+		in.read(reinterpret_cast<char*>(&value), sizeof(V));
+		if (!in) {
+			throw std::runtime_error("hub label file is truncated");
+		}
+		return value;
+	}
+
+	template <typename V>
+	static std::vector<V> read_vector(std::istream& in) {
+		const std::uint64_t size = read_value<std::uint64_t>(in);
+		std::vector<V> values;
+		// Wczytywanie porcjami, by uszkodzony rozmiar nie powodował jednej ogromnej alokacji.
+		constexpr std::uint64_t CHUNK = 1 << 20;
+		for (std::uint64_t done = 0; done < size;) {
+			const std::uint64_t step = std::min(CHUNK, size - done);
+			values.resize(static_cast<std::size_t>(done + step));
+			in.read(reinterpret_cast<char*>(values.data() + done), static_cast<std::streamsize>(step * sizeof(V)));
+			if (!in) {
+				throw std::runtime_error("hub label file is truncated");
+			}
+			done += step;
+		}
+		return values;
+	}
+};
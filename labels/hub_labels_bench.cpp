@@ -0,0 +1,125 @@
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HubLabels.h"
+#include "../algorithm/SearchKernel.h"
+#include "../ZTMGraphLoader.h"
+
+/// <summary>
+/// Pomiar indeksu etykiet hubów: czas budowy i skalowanie z liczbą wątków, rozmiar etykiet,
+/// zgodność z algorytmem Dijkstry, czas zapytania oraz zapis i odczyt indeksu.
+/// </summary>
+int main(int argc, char** argv)
+{
+	if (argc < 3) {
+		std::cerr << "usage: hub_labels_bench <stations> <routes> [--queries N] [--out FILE]" << std::endl;
+		return 1;
+	}
+	try {
+		std::size_t query_count = 100000;
+		std::string out_path;
+		for (int i = 3; i + 1 < argc; i += 2) {
+			const std::string option = argv[i];
+			if (option == "--queries") query_count = std::stoul(argv[i + 1]);
+			else if (option == "--out") out_path = argv[i + 1];
+		}
+
+		if (query_count == 0) {
+			throw std::runtime_error("--queries must be positive");
+		}
+
+		const auto graph = load_graph(argv[1], argv[2]);
+		const auto& adjacency = graph.get_adjacency();
+		const std::size_t n = adjacency.vertex_count();
+		if (n == 0) {
+			throw std::runtime_error("graph is empty");
+		}
+		std::cout << std::fixed << std::setprecision(2)
+			<< "vertices: " << n << ", edges: " << adjacency.edge_count() << std::endl;
+
+		HubLabels labels;
+		double sequential_ms = 0;
+		const unsigned int max_threads = std::max(1u, std::thread::hardware_concurrency());
+		for (unsigned int threads = 1; threads <= max_threads; threads *= 2) {
+			labels = HubLabels(adjacency, threads);
+			const HubLabelStats& stats = labels.get_stats();
+			if (threads == 1) {
+				sequential_ms = stats.build_ms;
+			}
+			std::cout << "threads " << std::setw(3) << threads
+				<< "  build " << std::setw(10) << stats.build_ms << " ms"
+				<< "  speedup " << std::setw(6) << (stats.build_ms > 0 ? sequential_ms / stats.build_ms : 0.0)
+				<< "  batches " << std::setw(7) << stats.batches
+				<< "  label size mean " << std::setw(8) << stats.mean_label_size
+				<< " max " << std::setw(6) << stats.max_label_size
+				<< "  size " << static_cast<double>(stats.bytes) / (1024.0 * 1024.0) << " MiB" << std::endl;
+		}
+
+		std::mt19937 random(12345);
+		std::uniform_int_distribution<VertexIndex> any(0, static_cast<VertexIndex>(n - 1));
+		std::vector<std::pair<VertexIndex, VertexIndex>> pairs(query_count);
+		for (auto& pair : pairs) {
+			pair = std::make_pair(any(random), any(random));
+		}
+
+		DijkstraKernel<double, policy::ExhaustAll> kernel;
+		std::size_t mismatches = 0;
+		const std::size_t checked_sources = std::min<std::size_t>(n, 200);
+		for (std::size_t i = 0; i < checked_sources; ++i) {
+			const VertexIndex s = pairs[i % pairs.size()].first;
+			kernel.run(adjacency, s, NO_VERTEX, policy::NoHeuristic());
+			for (VertexIndex t = 0; t < n; ++t) {
+				const double expected = kernel.get_distances()[t];
+				const double actual = labels.distance(s, t);
+				if (std::isinf(expected) != std::isinf(actual) || (!std::isinf(expected) && std::abs(expected - actual) > 1e-9)) {
+					++mismatches;
+				}
+			}
+		}
+		std::cout << "validated " << checked_sources << " sources against Dijkstra: " << mismatches << " mismatches" << std::endl;
+
+		double checksum = 0;
+		const auto started = std::chrono::steady_clock::now();
+		for (const auto& [s, t] : pairs) {
+			const double d = labels.distance(s, t);
+			checksum += std::isinf(d) ? 0.0 : d;
+		}
+		const double label_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count()
+			/ static_cast<double>(pairs.size());
+
+		DijkstraKernel<double> point_to_point;
+		const std::size_t dijkstra_queries = std::min<std::size_t>(pairs.size(), 10000);
+		const auto dijkstra_started = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < dijkstra_queries; ++i) {
+			point_to_point.run(adjacency, pairs[i].first, pairs[i].second, policy::NoHeuristic());
+		}
+		const double dijkstra_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - dijkstra_started).count()
+			/ static_cast<double>(dijkstra_queries);
+		std::cout << "distance query: " << label_ns << " ns (Dijkstra: " << dijkstra_ns << " ns, checksum " << checksum << ")" << std::endl;
+
+		if (!out_path.empty()) {
+			{
+				std::ofstream out(out_path, std::ios::binary | std::ios::trunc);
+				labels.save(out);
+			}
+			std::ifstream in(out_path, std::ios::binary);
+			const auto load_started = std::chrono::steady_clock::now();
+			const HubLabels loaded = HubLabels::load(in, adjacency);
+			const double load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_started).count();
+			std::cout << "saved to " << out_path << ", loaded in " << load_ms << " ms ("
+				<< loaded.get_stats().label_entries << " entries)" << std::endl;
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,500 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Partition.h"
+#include "../graph/Adjacency.h"
+
+/// <summary>
+/// Statystyki silnika routingu na nakładkach.
+/// </summary>
+struct OverlayStats {
+	/// <summary>
+	/// Czas wyznaczania podziału [ms]
+	/// </summary>
+	double partition_ms = 0;
+	/// <summary>
+	/// Czas ostatniej kustomizacji (pełnej lub częściowej) [ms]
+	/// </summary>
+	double customization_ms = 0;
+	/// <summary>
+	/// Liczba komórek przeliczonych w ostatniej kustomizacji
+	/// </summary>
+	std::size_t customized_cells = 0;
+	/// <summary>
+	/// Liczba wykonanych zapytań
+	/// </summary>
+	std::uint64_t queries = 0;
+	/// <summary>
+	/// Średni czas zapytania (z rozpakowaniem ścieżki) [us]
+	/// </summary>
+	double mean_query_us = 0;
+	/// <summary>
+	/// Najdłuższy czas zapytania [us]
+	/// </summary>
+	double max_query_us = 0;
+};
+
+/// <summary>
+/// Wynik zapytania silnika routingu: koszt oraz ścieżka jako ciąg indeksów wierzchołków.
+/// </summary>
+struct OverlayPath {
+	double cost = 0;
+	std::vector<VertexIndex> vertices;
+};
+
+/// <summary>
+/// Silnik routingu na wielopoziomowych nakładkach (w stylu CRP - customizable route planning).
+/// Przetwarzanie składa się z trzech faz:
+/// 1. podział (Partition) - zależy tylko od struktury grafu i lokalizacji, wykonywany raz,
+/// 2. kustomizacja - dla każdej komórki każdego poziomu wyznaczana jest klika odległości między jej
+///    wierzchołkami brzegowymi; komórki jednego poziomu liczone są równolegle, a po zmianie wag
+///    wystarczy przeliczyć komórki zawierające zmienione krawędzie,
+/// 3. zapytanie - Dijkstra po grafie nakładek: w komórkach źródła i celu po oryginalnych krawędziach,
+///    dalej po klikach najwyższego poziomu, na którym komórka nie zawiera źródła ani celu.
+/// </summary>
+class OverlayRouter
+{
+private:
+	static constexpr double INF = std::numeric_limits<double>::infinity();
+
+	/// <summary>
+	/// Nakładka jednego poziomu
+	/// </summary>
+	struct Level {
+		/// <summary>
+		/// Wierzchołki brzegowe kolejnych komórek
+		/// </summary>
+		std::vector<std::vector<VertexIndex>> boundary;
+		/// <summary>
+		/// Pozycja wierzchołka na liście brzegowej jego komórki (NO_VERTEX, jeśli nie jest brzegowy)
+		/// </summary>
+		std::vector<VertexIndex> boundary_index;
+		/// <summary>
+		/// Kliki komórek: cliques[c][i * |B| + j] - odległość od i-tego do j-tego wierzchołka brzegowego
+		/// </summary>
+		std::vector<std::vector<double>> cliques;
+	};
+
+	/// <summary>
+	/// Obszar roboczy wyszukiwania ograniczonego do komórki
+	/// </summary>
+	struct Workspace {
+		std::vector<double> dist;
+		std::vector<VertexIndex> previous;
+		std::vector<VertexIndex> touched;
+
+		void reset(const std::size_t n) {
+			if (dist.size() != n) {
+				dist.assign(n, INF);
+				previous.assign(n, NO_VERTEX);
+				touched.clear();
+				return;
+			}
+			for (const VertexIndex v : touched) {
+				dist[v] = INF;
+				previous[v] = NO_VERTEX;
+			}
+			touched.clear();
+		}
+		void set(const VertexIndex v, const double d, const VertexIndex p) {
+			if (dist[v] == INF) {
+				touched.push_back(v);
+			}
+			dist[v] = d;
+			previous[v] = p;
+		}
+	};
+
+	using Entry = std::pair<double, VertexIndex>;
+	using Heap = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+
+private:
+	const Adjacency<double>* adjacency = nullptr;
+	Partition partition;
+	std::vector<Level> levels;
+	unsigned int threads;
+
+	double partition_ms = 0;
+	// Statystyki kustomizacji i zapytań są atomowe, bo get_stats() może być wołane w trakcie kustomizacji.
+	std::atomic<std::uint64_t> customization_ns{ 0 };
+	std::atomic<std::size_t> customized_cells{ 0 };
+	mutable std::atomic<std::uint64_t> query_count{ 0 };
+	mutable std::atomic<std::uint64_t> query_total_ns{ 0 };
+	mutable std::atomic<std::uint64_t> query_max_ns{ 0 };
+
+public:
+	/// <summary>
+	/// Konstruktor wyznaczający podział i nakładki oraz wykonujący pierwszą kustomizację.
+	/// Obiekt przechowuje wskaźnik na listy sąsiedztwa, które muszą istnieć przez cały czas jego życia.
+	/// </summary>
+	/// <param name="adjacency">Listy sąsiedztwa grafu</param>
+	/// <param name="localizations">Lokalizacje wierzchołków</param>
+	/// <param name="cell_sizes">Maksymalne rozmiary komórek kolejnych poziomów (rosnąco)</param>
+	/// <param name="threads">Liczba wątków kustomizacji (0 - liczba rdzeni)</param>
+	OverlayRouter(
+		const Adjacency<double>& adjacency,
+		const Localizations& localizations,
+		const std::vector<std::size_t>& cell_sizes = { 64, 1024, 16384 },
+		const unsigned int threads = 0
+	) :
+		adjacency(&adjacency),
+		threads(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency()))
+	{
+		const auto started = std::chrono::steady_clock::now();
+		partition = Partition(adjacency, localizations, cell_sizes);
+		build_levels();
+		partition_ms = elapsed_ms(started);
+
+		customize();
+	}
+
+public:
+	/// <summary>
+	/// Funkcja przeliczająca kliki wszystkich komórek dla bieżących wag.
+	/// </summary>
+	void customize() {
+		std::vector<std::vector<VertexIndex>> all(levels.size());
+		for (std::size_t l = 0; l < levels.size(); ++l) {
+			for (VertexIndex c = 0; c < partition.cell_count(l); ++c) {
+				all[l].push_back(c);
+			}
+		}
+		customize_cells(all);
+	}
+	/// <summary>
+	/// Funkcja przeliczająca kliki tylko komórek zawierających wierzchołki zmienionych krawędzi.
+	/// </summary>
+	/// <param name="changed">Wierzchołki początkowe i końcowe krawędzi, których wagi się zmieniły</param>
+	void customize(const std::vector<VertexIndex>& changed) {
+		std::vector<std::vector<VertexIndex>> affected(levels.size());
+		for (std::size_t l = 0; l < levels.size(); ++l) {
+			for (const VertexIndex v : changed) {
+				affected[l].push_back(partition.cell(l, v));
+			}
+			std::sort(affected[l].begin(), affected[l].end());
+			affected[l].erase(std::unique(affected[l].begin(), affected[l].end()), affected[l].end());
+		}
+		customize_cells(affected);
+	}
+	/// <summary>
+	/// Funkcja szukająca najkrótszej ścieżki po nakładkach i rozpakowująca ją do ścieżki w oryginalnym grafie.
+	/// Może być wywoływana współbieżnie (ale nie w trakcie kustomizacji).
+	/// </summary>
+	/// <param name="start">Wierzchołek początkowy</param>
+	/// <param name="end">Wierzchołek końcowy</param>
+	/// <returns>Koszt i ścieżka, lub std::nullopt jeśli ścieżka nie istnieje</returns>
+	std::optional<OverlayPath> query(const VertexIndex start, const VertexIndex end) const {
+		const auto started = std::chrono::steady_clock::now();
+		auto result = search(start, end);
+		record_query(started);
+		return result;
+	}
+	/// <summary>
+	/// Getter statystyk
+	/// </summary>
+	/// <returns>Czasy podziału, kustomizacji i zapytań</returns>
+	OverlayStats get_stats() const {
+		OverlayStats result;
+		result.partition_ms = partition_ms;
+		result.customization_ms = static_cast<double>(customization_ns) / 1e6;
+		result.customized_cells = customized_cells;
+		result.queries = query_count;
+		result.mean_query_us = result.queries == 0 ? 0.0 : static_cast<double>(query_total_ns) / 1000.0 / static_cast<double>(result.queries);
+		result.max_query_us = static_cast<double>(query_max_ns) / 1000.0;
+		return result;
+	}
+	/// <summary>
+	/// Getter podziału
+	/// </summary>
+	const Partition& get_partition() const { return partition; }
+
+private:
+	void build_levels() {
+		const std::size_t n = adjacency->vertex_count();
+		levels.assign(partition.level_count(), Level());
+		for (std::size_t l = 0; l < levels.size(); ++l) {
+			Level& level = levels[l];
+			level.boundary.assign(partition.cell_count(l), {});
+			level.boundary_index.assign(n, NO_VERTEX);
+
+			std::vector<char> is_boundary(n, 0);
+			for (VertexIndex u = 0; u < n; ++u) {
+				for (std::size_t e = adjacency->begin(u); e < adjacency->end(u); ++e) {
+					const VertexIndex v = adjacency->get_targets()[e];
+					if (partition.cell(l, u) != partition.cell(l, v)) {
+						is_boundary[u] = 1;
+						is_boundary[v] = 1;
+					}
+				}
+			}
+			for (VertexIndex v = 0; v < n; ++v) {
+				if (is_boundary[v]) {
+					auto& cell_boundary = level.boundary[partition.cell(l, v)];
+					level.boundary_index[v] = static_cast<VertexIndex>(cell_boundary.size());
+					cell_boundary.push_back(v);
+				}
+			}
+			level.cliques.assign(partition.cell_count(l), {});
+			for (std::size_t c = 0; c < level.boundary.size(); ++c) {
+				const std::size_t b = level.boundary[c].size();
+				level.cliques[c].assign(b * b, INF);
+			}
+		}
+	}
+
+	void customize_cells(const std::vector<std::vector<VertexIndex>>& cells) {
+		const auto started = std::chrono::steady_clock::now();
+		std::size_t count = 0;
+		// Poziomy liczone są kolejno od dołu, bo kliki poziomu l korzystają z klik poziomu l - 1.
+		for (std::size_t l = 0; l < levels.size(); ++l) {
+			std::atomic<std::size_t> next{ 0 };
+			const auto worker = [&]() {
+				Workspace workspace;
+				for (std::size_t i = next++; i < cells[l].size(); i = next++) {
+					customize_cell(l, cells[l][i], workspace);
+				}
+			};
+			std::vector<std::thread> pool;
+			const unsigned int workers = static_cast<unsigned int>(std::min<std::size_t>(threads, cells[l].size()));
+			for (unsigned int t = 1; t < workers; ++t) {
+				pool.emplace_back(worker);
+			}
+			worker();
+			for (auto& thread : pool) {
+				thread.join();
+			}
+			count += cells[l].size();
+		}
+		customization_ns = static_cast<std::uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count()
+		);
+		customized_cells = count;
+	}
+
+	void customize_cell(const std::size_t l, const VertexIndex c, Workspace& workspace) {
+		const auto& boundary = levels[l].boundary[c];
+		auto& clique = levels[l].cliques[c];
+		const std::size_t b = boundary.size();
+		for (std::size_t i = 0; i < b; ++i) {
+			cell_search(l, c, boundary[i], NO_VERTEX, workspace);
+			for (std::size_t j = 0; j < b; ++j) {
+				clique[i * b + j] = workspace.dist[boundary[j]];
+			}
+		}
+	}
+
+	/// <summary>
+	/// Dijkstra ograniczony do komórki c poziomu l. Na poziomie 0 przeszukiwany jest oryginalny graf,
+	/// na wyższych poziomach graf nakładki poziomu l - 1 (kliki podkomórek i krawędzie między nimi).
+	/// </summary>
+	void cell_search(
+		const std::size_t l,
+		const VertexIndex c,
+		const VertexIndex source,
+		const VertexIndex target,
+		Workspace& workspace
+	) const {
+		workspace.reset(adjacency->vertex_count());
+		Heap heap;
+		workspace.set(source, 0.0, NO_VERTEX);
+		heap.push(std::make_pair(0.0, source));
+
+		const auto relax = [&](const VertexIndex u, const VertexIndex v, const double d) {
+			if (d < workspace.dist[v]) {
+				workspace.set(v, d, u);
+				heap.push(std::make_pair(d, v));
+			}
+		};
+
+		while (!heap.empty()) {
+			const auto [d, u] = heap.top();
+			heap.pop();
+			if (d > workspace.dist[u]) {
+				continue;
+			}
+			if (u == target) {
+				break;
+			}
+
+			if (l == 0) {
+				for (std::size_t e = adjacency->begin(u); e < adjacency->end(u); ++e) {
+					const VertexIndex v = adjacency->get_targets()[e];
+					if (partition.cell(0, v) == c) {
+						relax(u, v, d + adjacency->get_weights()[e]);
+					}
+				}
+				continue;
+			}
+
+			const Level& lower = levels[l - 1];
+			const VertexIndex sub = partition.cell(l - 1, u);
+			const auto& sub_boundary = lower.boundary[sub];
+			const auto& sub_clique = lower.cliques[sub];
+			const std::size_t i = lower.boundary_index[u];
+			const std::size_t b = sub_boundary.size();
+			for (std::size_t j = 0; j < b; ++j) {
+				relax(u, sub_boundary[j], d + sub_clique[i * b + j]);
+			}
+			for (std::size_t e = adjacency->begin(u); e < adjacency->end(u); ++e) {
+				const VertexIndex v = adjacency->get_targets()[e];
+				if (partition.cell(l, v) == c && partition.cell(l - 1, v) != sub) {
+					relax(u, v, d + adjacency->get_weights()[e]);
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// Poziom zapytania wierzchołka: 0 - oryginalne krawędzie, k - kliki poziomu k - 1.
+	/// </summary>
+	std::size_t query_level(const VertexIndex v, const VertexIndex start, const VertexIndex end) const {
+		std::size_t level = 0;
+		while (level < levels.size()
+			&& partition.cell(level, v) != partition.cell(level, start)
+			&& partition.cell(level, v) != partition.cell(level, end)) {
+			++level;
+		}
+		return level;
+	}
+
+	std::optional<OverlayPath> search(const VertexIndex start, const VertexIndex end) const {
+		// Poprzednik wierzchołka: (wierzchołek, poziom kliki + 1) lub (wierzchołek, 0) dla oryginalnej krawędzi.
+		Workspace workspace;
+		workspace.reset(adjacency->vertex_count());
+		std::vector<std::size_t> via(adjacency->vertex_count(), 0);
+		Heap heap;
+		workspace.set(start, 0.0, NO_VERTEX);
+		heap.push(std::make_pair(0.0, start));
+
+		const auto relax = [&](const VertexIndex u, const VertexIndex v, const double d, const std::size_t arc) {
+			if (d < workspace.dist[v]) {
+				workspace.set(v, d, u);
+				via[v] = arc;
+				heap.push(std::make_pair(d, v));
+			}
+		};
+
+		while (!heap.empty()) {
+			const auto [d, u] = heap.top();
+			heap.pop();
+			if (d > workspace.dist[u]) {
+				continue;
+			}
+			if (u == end) {
+				break;
+			}
+
+			const std::size_t q = query_level(u, start, end);
+			if (q == 0) {
+				for (std::size_t e = adjacency->begin(u); e < adjacency->end(u); ++e) {
+					relax(u, adjacency->get_targets()[e], d + adjacency->get_weights()[e], 0);
+				}
+				continue;
+			}
+
+			const std::size_t l = q - 1;
+			const Level& level = levels[l];
+			const VertexIndex c = partition.cell(l, u);
+			const auto& boundary = level.boundary[c];
+			const auto& clique = level.cliques[c];
+			const std::size_t i = level.boundary_index[u];
+			const std::size_t b = boundary.size();
+			for (std::size_t j = 0; j < b; ++j) {
+				if (boundary[j] != u) {
+					relax(u, boundary[j], d + clique[i * b + j], q);
+				}
+			}
+			for (std::size_t e = adjacency->begin(u); e < adjacency->end(u); ++e) {
+				const VertexIndex v = adjacency->get_targets()[e];
+				if (partition.cell(l, v) != c) {
+					relax(u, v, d + adjacency->get_weights()[e], 0);
+				}
+			}
+		}
+
+		if (workspace.dist[end] == INF) {
+			return std::nullopt;
+		}
+
+		OverlayPath path;
+		path.cost = workspace.dist[end];
+		path.vertices.push_back(end);
+		Workspace unpack;
+		for (VertexIndex v = end; v != start; v = workspace.previous[v]) {
+			const VertexIndex u = workspace.previous[v];
+			if (via[v] == 0) {
+				path.vertices.push_back(u);
+				continue;
+			}
+			// Rozpakowanie krawędzi kliki: najkrótsza ścieżka w oryginalnym grafie ograniczona do komórki.
+			const std::size_t l = via[v] - 1;
+			unpack_in_cell(l, partition.cell(l, u), u, v, unpack, path.vertices);
+		}
+		std::reverse(path.vertices.begin(), path.vertices.end());
+		return path;
+	}
+
+	/// <summary>
+	/// Funkcja dopisująca (od końca) wierzchołki najkrótszej ścieżki u -> v wewnątrz komórki c poziomu l, bez v.
+	/// </summary>
+	void unpack_in_cell(
+		const std::size_t l,
+		const VertexIndex c,
+		const VertexIndex u,
+		const VertexIndex v,
+		Workspace& workspace,
+		std::vector<VertexIndex>& reversed_path
+	) const {
+		workspace.reset(adjacency->vertex_count());
+		Heap heap;
+		workspace.set(u, 0.0, NO_VERTEX);
+		heap.push(std::make_pair(0.0, u));
+		while (!heap.empty()) {
+			const auto [d, x] = heap.top();
+			heap.pop();
+			if (d > workspace.dist[x]) {
+				continue;
+			}
+			if (x == v) {
+				break;
+			}
+			for (std::size_t e = adjacency->begin(x); e < adjacency->end(x); ++e) {
+				const VertexIndex y = adjacency->get_targets()[e];
+				const double alt = d + adjacency->get_weights()[e];
+				if (partition.cell(l, y) == c && alt < workspace.dist[y]) {
+					workspace.set(y, alt, x);
+					heap.push(std::make_pair(alt, y));
+				}
+			}
+		}
+		for (VertexIndex x = workspace.previous[v]; x != NO_VERTEX; x = workspace.previous[x]) {
+			reversed_path.push_back(x);
+		}
+	}
+
+	void record_query(const std::chrono::steady_clock::time_point started) const {
+		const auto ns = static_cast<std::uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count()
+		);
+		++query_count;
+		query_total_ns += ns;
+		std::uint64_t max = query_max_ns;
+		while (ns > max && !query_max_ns.compare_exchange_weak(max, ns)) {}
+	}
+
+	static double elapsed_ms(const std::chrono::steady_clock::time_point started) {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+	}
+};
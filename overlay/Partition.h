@@ -0,0 +1,193 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../graph/Adjacency.h"
+#include "../Localizations.h"
+
+/// <summary>
+/// Wielopoziomowy, niezależny od wag podział grafu na komórki.
+/// Poziom 0 zawiera najmniejsze komórki, każda komórka poziomu l + 1 jest sumą komórek poziomu l.
+/// Podział wyznaczany jest rekurencyjną bisekcją po współrzędnych (wzdłuż osi o większym rozrzucie),
+/// a punkt cięcia wybierany jest w otoczeniu mediany tak, by przecinał jak najmniej krawędzi.
+/// </summary>
+class Partition
+{
+private:
+	/// <summary>
+	/// Komórki wierzchołków na kolejnych poziomach: cells[l][v]
+	/// </summary>
+	std::vector<std::vector<VertexIndex>> cells;
+	/// <summary>
+	/// Liczba komórek na kolejnych poziomach
+	/// </summary>
+	std::vector<std::size_t> cell_counts;
+
+public:
+	/// <summary>
+	/// Konstruktor domyślny
+	/// </summary>
+	Partition() {}
+	/// <summary>
+	/// Konstruktor wyznaczający podział.
+	/// </summary>
+	/// <typeparam name="W">Typ wagi (wagi nie są używane).</typeparam>
+	/// <param name="adjacency">Listy sąsiedztwa grafu</param>
+	/// <param name="localizations">Lokalizacje wierzchołków</param>
+	/// <param name="cell_sizes">Maksymalne rozmiary komórek kolejnych poziomów (rosnąco)</param>
+	/// <param name="balance">Dopuszczalne odchylenie punktu cięcia od mediany (ułamek rozmiaru)</param>
+	template <typename W>
+	Partition(
+		const Adjacency<W>& adjacency,
+		const Localizations& localizations,
+		const std::vector<std::size_t>& cell_sizes,
+		const double balance = 0.1
+	) {
+		const std::size_t n = adjacency.vertex_count();
+		if (localizations.size() != n) {
+			throw std::runtime_error("partition requires a localization for every vertex");
+		}
+		if (cell_sizes.empty() || !std::is_sorted(cell_sizes.begin(), cell_sizes.end()) || cell_sizes.front() == 0) {
+			throw std::runtime_error("cell sizes must be positive and ascending");
+		}
+
+		const std::size_t levels = cell_sizes.size();
+		cells.assign(levels, std::vector<VertexIndex>(n, NO_VERTEX));
+		cell_counts.assign(levels, 0);
+
+		// Krawędzie nieskierowane - do liczenia przeciętych krawędzi przy wyborze punktu cięcia.
+		std::vector<std::pair<std::pair<VertexIndex, VertexIndex>, char>> symmetric;
+		symmetric.reserve(2 * adjacency.edge_count());
+		for (VertexIndex u = 0; u < n; ++u) {
+			for (std::size_t e = adjacency.begin(u); e < adjacency.end(u); ++e) {
+				const VertexIndex v = adjacency.get_targets()[e];
+				symmetric.push_back(std::make_pair(std::make_pair(u, v), char(0)));
+				symmetric.push_back(std::make_pair(std::make_pair(v, u), char(0)));
+			}
+		}
+		const Adjacency<char> undirected(n, symmetric);
+
+		std::vector<VertexIndex> order(n);
+		for (VertexIndex v = 0; v < n; ++v) {
+			order[v] = v;
+		}
+		std::vector<char> side(n, 0);
+
+		struct Range {
+			std::size_t begin;
+			std::size_t end;
+			int next_level;
+		};
+		std::vector<Range> stack;
+		stack.push_back(Range{ 0, n, static_cast<int>(levels) - 1 });
+		while (!stack.empty()) {
+			Range range = stack.back();
+			stack.pop_back();
+			const std::size_t size = range.end - range.begin;
+			if (size == 0) {
+				continue;
+			}
+
+			while (range.next_level >= 0 && size <= cell_sizes[range.next_level]) {
+				const std::size_t l = static_cast<std::size_t>(range.next_level);
+				for (std::size_t i = range.begin; i < range.end; ++i) {
+					cells[l][order[i]] = static_cast<VertexIndex>(cell_counts[l]);
+				}
+				++cell_counts[l];
+				--range.next_level;
+			}
+			if (range.next_level < 0) {
+				continue;
+			}
+
+			const std::size_t middle = split(order, range.begin, range.end, localizations, undirected, side, balance);
+			stack.push_back(Range{ range.begin, middle, range.next_level });
+			stack.push_back(Range{ middle, range.end, range.next_level });
+		}
+	}
+
+public:
+	/// <summary>
+	/// Liczba poziomów
+	/// </summary>
+	std::size_t level_count() const { return cells.size(); }
+	/// <summary>
+	/// Liczba komórek na poziomie
+	/// </summary>
+	/// <param name="level">Poziom</param>
+	std::size_t cell_count(const std::size_t level) const { return cell_counts[level]; }
+	/// <summary>
+	/// Komórka wierzchołka na poziomie
+	/// </summary>
+	/// <param name="level">Poziom</param>
+	/// <param name="v">Wierzchołek</param>
+	VertexIndex cell(const std::size_t level, const VertexIndex v) const { return cells[level][v]; }
+
+private:
+	/// <summary>
+	/// Funkcja dzieląca zakres order[begin, end) na dwie części i zwracająca punkt podziału.
+	/// </summary>
+	static std::size_t split(
+		std::vector<VertexIndex>& order,
+		const std::size_t begin,
+		const std::size_t end,
+		const Localizations& localizations,
+		const Adjacency<char>& undirected,
+		std::vector<char>& side,
+		const double balance
+	) {
+		const auto& xs = localizations.get_x();
+		const auto& ys = localizations.get_y();
+
+		double min_x = xs[order[begin]], max_x = min_x, min_y = ys[order[begin]], max_y = min_y;
+		for (std::size_t i = begin; i < end; ++i) {
+			min_x = std::min(min_x, xs[order[i]]);
+			max_x = std::max(max_x, xs[order[i]]);
+			min_y = std::min(min_y, ys[order[i]]);
+			max_y = std::max(max_y, ys[order[i]]);
+		}
+		const std::vector<double>& axis = (max_x - min_x >= max_y - min_y) ? xs : ys;
+		std::sort(order.begin() + begin, order.begin() + end, [&](const VertexIndex a, const VertexIndex b) {
+			return axis[a] < axis[b] || (axis[a] == axis[b] && a < b);
+		});
+
+		const std::size_t size = end - begin;
+		const std::size_t slack = static_cast<std::size_t>(balance * static_cast<double>(size));
+		const std::size_t half = size / 2;
+		const std::size_t first = begin + std::max<std::size_t>(1, half > slack ? half - slack : 1);
+		const std::size_t last = begin + std::min(size - 1, half + slack);
+
+		// side: 1 - po lewej stronie cięcia, 2 - po prawej, 0 - poza zakresem.
+		for (std::size_t i = begin; i < end; ++i) {
+			side[order[i]] = 2;
+		}
+		long long cut = 0;
+		std::size_t best = begin + half;
+		long long best_cut = -1;
+		for (std::size_t i = begin; i < last; ++i) {
+			const VertexIndex v = order[i];
+			for (std::size_t e = undirected.begin(v); e < undirected.end(v); ++e) {
+				const char other = side[undirected.get_targets()[e]];
+				if (other == 1) {
+					--cut;
+				}
+				else if (other == 2) {
+					++cut;
+				}
+			}
+			side[v] = 1;
+			if (i + 1 >= first && (best_cut < 0 || cut < best_cut)) {
+				best_cut = cut;
+				best = i + 1;
+			}
+		}
+		for (std::size_t i = begin; i < end; ++i) {
+			side[order[i]] = 0;
+		}
+		return best;
+	}
+};
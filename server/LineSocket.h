@@ -0,0 +1,139 @@
+﻿#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/// <summary>
+/// Funkcja wyznaczająca adres gniazda uniksowego
+/// </summary>
+/// <param name="path">Ścieżka gniazda</param>
+/// <returns>Adres</returns>
+inline sockaddr_un unix_address(const std::string& path) {
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(address.sun_path)) {
+		throw std::runtime_error("socket path too long: " + path);
+	}
+	std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+	return address;
+}
+
+/// <summary>
+/// Funkcja tworząca gniazdo uniksowe nasłuchujące pod podaną ścieżką (istniejący plik jest usuwany)
+/// </summary>
+/// <param name="path">Ścieżka gniazda</param>
+/// <returns>Deskryptor gniazda</returns>
+inline int listen_unix(const std::string& path) {
+	const sockaddr_un address = unix_address(path);
+	const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) {
+		throw std::runtime_error("cannot create socket");
+	}
+	::unlink(path.c_str());
+	if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 || ::listen(fd, 64) < 0) {
+		::close(fd);
+		throw std::runtime_error("cannot listen on " + path);
+	}
+	return fd;
+}
+
+/// <summary>
+/// Funkcja łącząca się z gniazdem uniksowym
+/// </summary>
+/// <param name="path">Ścieżka gniazda</param>
+/// <returns>Deskryptor połączenia</returns>
+inline int connect_unix(const std::string& path) {
+	const sockaddr_un address = unix_address(path);
+	const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) {
+		throw std::runtime_error("cannot create socket");
+	}
+	if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+		::close(fd);
+		throw std::runtime_error("cannot connect to " + path);
+	}
+	return fd;
+}
+
+/// <summary>
+/// Funkcja wysyłająca całą linię. Zwraca false, jeśli druga strona zamknęła połączenie (EPIPE, ECONNRESET);
+/// MSG_NOSIGNAL (oraz ignorowany SIGPIPE na platformach bez tej flagi) zapobiega zakończeniu procesu.
+/// </summary>
+/// <param name="fd">Deskryptor połączenia</param>
+/// <param name="line">Linia (ze znakiem końca linii)</param>
+/// <returns>true, jeśli wysłano całą linię</returns>
+inline bool send_line(const int fd, const std::string& line) {
+	for (std::size_t written = 0; written < line.size();) {
+		const ssize_t n = ::send(fd, line.data() + written, line.size() - written, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			return false;
+		}
+		written += static_cast<std::size_t>(n);
+	}
+	return true;
+}
+
+/// <summary>
+/// Czytnik kolejnych linii z połączenia (bez znaków "\r\n").
+/// </summary>
+class LineReader
+{
+private:
+	const int fd;
+	std::string buffer;
+	std::size_t begin = 0;
+
+public:
+	/// <summary>
+	/// Konstruktor klasy LineReader
+	/// </summary>
+	/// <param name="fd">Deskryptor połączenia (nie jest zamykany przez czytnik)</param>
+	explicit LineReader(const int fd) : fd(fd) {}
+
+public:
+	/// <summary>
+	/// Funkcja czytająca następną linię
+	/// </summary>
+	/// <param name="line">Odczytana linia</param>
+	/// <returns>false, jeśli połączenie zostało zamknięte (niepełna ostatnia linia jest pomijana)</returns>
+	bool next(std::string& line) {
+		while (true) {
+			const std::size_t end = buffer.find('\n', begin);
+			if (end != std::string::npos) {
+				line.assign(buffer, begin, end - begin);
+				begin = end + 1;
+				if (!line.empty() && line.back() == '\r') {
+					line.pop_back();
+				}
+				return true;
+			}
+			buffer.erase(0, begin);
+			begin = 0;
+
+			char chunk[4096];
+			const ssize_t n = ::read(fd, chunk, sizeof(chunk));
+			if (n < 0 && errno == EINTR) {
+				continue;
+			}
+			if (n <= 0) {
+				return false;
+			}
+			buffer.append(chunk, static_cast<std::size_t>(n));
+		}
+	}
+};
+#endif
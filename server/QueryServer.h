@@ -0,0 +1,409 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "WorkerPool.h"
+#include "../async/QueryScheduler.h"
+#include "../ZTMGraphData.h"
+#include "../algorithm/AStar.h"
+#include "../algorithm/BellmanFord.h"
+#include "../algorithm/Dijkstra.h"
+
+/// <summary>
+/// Konfiguracja serwera zapytań.
+/// </summary>
+struct ServerConfig {
+	/// <summary>
+	/// Liczba wątków roboczych (0 - liczba rdzeni)
+	/// </summary>
+	unsigned int threads = 0;
+	/// <summary>
+	/// Maksymalna liczba zapytań w jednej paczce
+	/// </summary>
+	std::size_t max_batch = 256;
+	/// <summary>
+	/// Maksymalny czas oczekiwania na zebranie paczki, liczony od pierwszego zapytania w paczce
+	/// </summary>
+	std::chrono::microseconds batch_window{ 500 };
+	/// <summary>
+	/// Termin zapytań z nazwą algorytmu, liczony od rozpoczęcia paczki (0 - bez terminu)
+	/// </summary>
+	std::chrono::milliseconds query_timeout{ 0 };
+};
+
+/// <summary>
+/// Statystyki serwera zapytań.
+/// </summary>
+struct ServerStats {
+	std::uint64_t queries = 0;
+	std::uint64_t batches = 0;
+	/// <summary>
+	/// Liczba przeszukań grafu (zapytania z tego samego źródła w paczce dzielą jedno przeszukanie)
+	/// </summary>
+	std::uint64_t searches = 0;
+	/// <summary>
+	/// Liczba zapytań przerwanych po upływie terminu
+	/// </summary>
+	std::uint64_t timeouts = 0;
+};
+
+/// <summary>
+/// Strumień odpowiedzi jednego klienta. Odpowiedzi mogą być gotowe w dowolnej kolejności,
+/// ale są przekazywane do ujścia (sink) w kolejności numerów sekwencyjnych zapytań.
+/// </summary>
+class ResponseStream
+{
+public:
+	using Sink = std::function<void(std::uint64_t sequence, const std::string& response)>;
+
+private:
+	const Sink sink;
+	std::mutex mutex;
+	std::condition_variable drained;
+	std::map<std::uint64_t, std::string> ready;
+	std::uint64_t issued = 0;
+	std::uint64_t delivered = 0;
+
+public:
+	/// <summary>
+	/// Konstruktor klasy ResponseStream
+	/// </summary>
+	/// <param name="sink">Funkcja odbierająca kolejne odpowiedzi (wywoływana pod blokadą strumienia)</param>
+	explicit ResponseStream(Sink sink) : sink(std::move(sink)) {}
+
+public:
+	/// <summary>
+	/// Funkcja nadająca numer sekwencyjny kolejnemu zapytaniu
+	/// </summary>
+	std::uint64_t next_sequence() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return issued++;
+	}
+	/// <summary>
+	/// Funkcja przekazująca gotową odpowiedź; wysyła wszystkie odpowiedzi, na które czekała kolejka.
+	/// </summary>
+	/// <param name="sequence">Numer sekwencyjny zapytania</param>
+	/// <param name="response">Odpowiedź</param>
+	void complete(const std::uint64_t sequence, std::string response) {
+		std::lock_guard<std::mutex> lock(mutex);
+		ready.emplace(sequence, std::move(response));
+		for (auto it = ready.find(delivered); it != ready.end(); it = ready.find(delivered)) {
+			sink(it->first, it->second);
+			ready.erase(it);
+			++delivered;
+		}
+		if (delivered == issued) {
+			drained.notify_all();
+		}
+	}
+	/// <summary>
+	/// Funkcja czekająca na wysłanie odpowiedzi na wszystkie zadane zapytania
+	/// </summary>
+	void wait_until_drained() {
+		std::unique_lock<std::mutex> lock(mutex);
+		drained.wait(lock, [this] { return delivered == issued; });
+	}
+};
+
+/// <summary>
+/// Serwer zapytań o najkrótsze ścieżki w protokole liniowym.
+/// Zapytanie: "&lt;id_z&gt; &lt;id_do&gt;" (najkrótsza ścieżka) lub "&lt;algorytm&gt; &lt;id_z&gt; &lt;id_do&gt;"
+/// (algorytm: dijkstra, astar, bellmanford). Odpowiedź: "OK &lt;koszt&gt; &lt;id&gt; ...", "NOPATH", "ERROR &lt;opis&gt;"
+/// lub "TIMEOUT [&lt;koszt&gt; &lt;id&gt; ...]" (najlepsza znaleziona ścieżka, jeśli termin upłynął po osiągnięciu celu).
+/// Zapytania zbierane są w paczki; zapytania bez nazwy algorytmu z tego samego źródła są obsługiwane
+/// jednym przeszukaniem jeden-do-wielu. Zapytania z nazwą algorytmu wykonywane są jako korutyny (solve_async)
+/// przeplatane przez QueryScheduler, więc długie zapytanie nie blokuje krótszych z tej samej paczki.
+/// Paczki wykonywane są przez pulę wątków, a odpowiedzi wysyłane w kolejności zapytań
+/// (przetwarzanie potokowe: odczyt, wyszukiwanie i zapis odbywają się równolegle).
+/// </summary>
+class QueryServer
+{
+private:
+	struct Request {
+		ResponseStream* stream;
+		std::uint64_t sequence;
+		std::string algorithm;
+		VertexIndex from;
+		VertexIndex to;
+	};
+
+private:
+	const Graph<Station>& graph;
+	const ServerConfig config;
+	std::unordered_map<unsigned int, VertexIndex> stations_by_id;
+	std::unordered_map<std::string, std::unique_ptr<Algorithm<Station>>> algorithms;
+
+	std::atomic<std::uint64_t> query_count{ 0 };
+	std::atomic<std::uint64_t> batch_count{ 0 };
+	std::atomic<std::uint64_t> search_count{ 0 };
+	std::atomic<std::uint64_t> timeout_count{ 0 };
+
+	WorkerPool pool;
+
+	std::mutex mutex;
+	std::condition_variable pending_changed;
+	std::vector<Request> pending;
+	bool stopping = false;
+	std::thread dispatcher;
+
+public:
+	/// <summary>
+	/// Konstruktor klasy QueryServer
+	/// </summary>
+	/// <param name="graph">Graf przystanków (musi istnieć przez cały czas życia serwera)</param>
+	/// <param name="config">Konfiguracja</param>
+	QueryServer(const Graph<Station>& graph, const ServerConfig& config = ServerConfig()) :
+		graph(graph),
+		config(config),
+		pool(config.threads)
+	{
+		for (VertexIndex v = 0; v < graph.get_vertices().size(); ++v) {
+			stations_by_id.insert(std::make_pair(graph.get_vertices()[v]->get_data().get_id(), v));
+		}
+		algorithms.emplace("dijkstra", std::make_unique<Dijkstra<Station>>());
+		algorithms.emplace("astar", std::make_unique<AStar<Station>>());
+		algorithms.emplace("bellmanford", std::make_unique<BellmanFord<Station>>());
+
+		dispatcher = std::thread([this] { dispatch_loop(); });
+	}
+	/// <summary>
+	/// Destruktor - obsługuje wszystkie przyjęte zapytania i zatrzymuje wątki
+	/// </summary>
+	~QueryServer() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		pending_changed.notify_all();
+		dispatcher.join();
+	}
+
+	QueryServer(const QueryServer&) = delete;
+	QueryServer& operator=(const QueryServer&) = delete;
+
+public:
+	/// <summary>
+	/// Funkcja przyjmująca jedną linię zapytania. Odpowiedź trafi do strumienia stream.
+	/// </summary>
+	/// <param name="stream">Strumień odpowiedzi klienta</param>
+	/// <param name="line">Linia zapytania</param>
+	void submit(ResponseStream& stream, const std::string& line) {
+		const std::uint64_t sequence = stream.next_sequence();
+		++query_count;
+
+		std::istringstream tokens(line);
+		std::vector<std::string> words;
+		for (std::string word; tokens >> word;) {
+			words.push_back(word);
+		}
+		if (words.size() != 2 && words.size() != 3) {
+			stream.complete(sequence, "ERROR expected: [algorithm] <from_id> <to_id>");
+			return;
+		}
+
+		Request request{ &stream, sequence, words.size() == 3 ? words[0] : std::string(), NO_VERTEX, NO_VERTEX };
+		if (!request.algorithm.empty() && algorithms.find(request.algorithm) == algorithms.end()) {
+			stream.complete(sequence, "ERROR unknown algorithm " + request.algorithm);
+			return;
+		}
+		try {
+			request.from = station(words[words.size() - 2]);
+			request.to = station(words[words.size() - 1]);
+		}
+		catch (const std::exception& e) {
+			stream.complete(sequence, std::string("ERROR ") + e.what());
+			return;
+		}
+
+		bool wake = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pending.push_back(std::move(request));
+			wake = pending.size() == 1 || pending.size() >= config.max_batch;
+		}
+		if (wake) {
+			pending_changed.notify_one();
+		}
+	}
+	/// <summary>
+	/// Funkcja obsługująca klienta: czyta zapytania z in do końca strumienia i zapisuje odpowiedzi do out.
+	/// </summary>
+	/// <param name="in">Strumień zapytań</param>
+	/// <param name="out">Strumień odpowiedzi</param>
+	void serve(std::istream& in, std::ostream& out) {
+		ResponseStream stream([&out](std::uint64_t, const std::string& response) {
+			out << response << '\n';
+			out.flush();
+		});
+		for (std::string line; std::getline(in, line);) {
+			if (!line.empty() && line.back() == '\r') {
+				line.pop_back();
+			}
+			if (line.empty()) {
+				continue;
+			}
+			submit(stream, line);
+		}
+		stream.wait_until_drained();
+	}
+	/// <summary>
+	/// Getter statystyk serwera
+	/// </summary>
+	ServerStats get_stats() const {
+		ServerStats stats;
+		stats.queries = query_count;
+		stats.batches = batch_count;
+		stats.searches = search_count;
+		stats.timeouts = timeout_count;
+		return stats;
+	}
+
+private:
+	VertexIndex station(const std::string& text) const {
+		const auto not_digit = [](const char c) { return c < '0' || c > '9'; };
+		if (text.empty() || text.size() > 9 || std::any_of(text.begin(), text.end(), not_digit)) {
+			throw std::runtime_error("invalid station id " + text);
+		}
+		const auto it = stations_by_id.find(static_cast<unsigned int>(std::stoul(text)));
+		if (it == stations_by_id.end()) {
+			throw std::runtime_error("unknown station " + text);
+		}
+		return it->second;
+	}
+
+	void dispatch_loop() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			pending_changed.wait(lock, [this] { return stopping || !pending.empty(); });
+			if (pending.empty()) {
+				return;
+			}
+			const auto deadline = std::chrono::steady_clock::now() + config.batch_window;
+			pending_changed.wait_until(lock, deadline, [this] {
+				return stopping || pending.size() >= config.max_batch;
+			});
+
+			std::vector<Request> batch;
+			batch.swap(pending);
+			lock.unlock();
+			dispatch(std::move(batch));
+			lock.lock();
+		}
+	}
+
+	void dispatch(std::vector<Request> batch) {
+		++batch_count;
+		std::unordered_map<VertexIndex, std::vector<Request>> by_source;
+		std::vector<std::vector<Request>> singles(pool.size());
+		std::size_t single_count = 0;
+		for (auto& request : batch) {
+			if (request.algorithm.empty()) {
+				by_source[request.from].push_back(std::move(request));
+			}
+			else {
+				singles[single_count++ % singles.size()].push_back(std::move(request));
+			}
+		}
+		const auto deadline = config.query_timeout.count() > 0
+			? std::chrono::steady_clock::now() + config.query_timeout
+			: std::chrono::steady_clock::time_point::max();
+		for (auto& requests : singles) {
+			if (!requests.empty()) {
+				pool.post([this, deadline, requests = std::move(requests)] { solve_singles(requests, deadline); });
+			}
+		}
+		for (auto& [source, group] : by_source) {
+			pool.post([this, source = source, group = std::move(group)] { solve_group(source, group); });
+		}
+	}
+
+	void solve_singles(const std::vector<Request>& requests, const std::chrono::steady_clock::time_point deadline) {
+		const auto& vertices = graph.get_vertices();
+		QueryScheduler<AsyncResult<Station>> scheduler;
+		for (const Request& request : requests) {
+			++search_count;
+			QueryLimits limits;
+			limits.deadline = deadline;
+			scheduler.submit(
+				algorithms.at(request.algorithm)->solve_async(graph, vertices[request.from], vertices[request.to], limits),
+				[this, &request](QueryTask<AsyncResult<Station>>& task) { complete_single(request, task); }
+			);
+		}
+		scheduler.run();
+	}
+
+	void complete_single(const Request& request, QueryTask<AsyncResult<Station>>& task) {
+		std::string response;
+		try {
+			const AsyncResult<Station> outcome = task.get();
+			if (!outcome.is_final()) {
+				++timeout_count;
+			}
+			if (outcome.result) {
+				std::ostringstream out;
+				out << (outcome.is_final() ? "OK " : "TIMEOUT ") << outcome.result->get_cost();
+				for (const auto& vertex : outcome.result->get_path()) {
+					out << ' ' << vertex->get_data().get_id();
+				}
+				response = out.str();
+			}
+			else {
+				response = outcome.is_final() ? "NOPATH" : "TIMEOUT";
+			}
+		}
+		catch (const std::exception& e) {
+			response = std::string("ERROR ") + e.what();
+		}
+		request.stream->complete(request.sequence, std::move(response));
+	}
+
+	void solve_group(const VertexIndex source, const std::vector<Request>& group) {
+		thread_local DijkstraKernel<double, policy::StopAfterTargets> kernel;
+
+		std::vector<VertexIndex> targets;
+		for (const auto& request : group) {
+			if (graph.get_connectivity().reachable(source, request.to)) {
+				targets.push_back(request.to);
+			}
+		}
+		if (!targets.empty()) {
+			++search_count;
+			kernel.get_stop().set_targets(graph.get_vertices().size(), targets);
+			kernel.run(graph.get_adjacency(), source, NO_VERTEX, policy::NoHeuristic());
+		}
+
+		std::vector<VertexIndex> path;
+		for (const auto& request : group) {
+			if (targets.empty() || !kernel.reached(request.to)) {
+				request.stream->complete(request.sequence, "NOPATH");
+				continue;
+			}
+			path.clear();
+			for (VertexIndex v = request.to; v != NO_VERTEX; v = kernel.get_previous()[v]) {
+				path.push_back(v);
+			}
+			std::ostringstream out;
+			out << "OK " << kernel.get_distances()[request.to];
+			for (auto it = path.rbegin(); it != path.rend(); ++it) {
+				out << ' ' << graph.get_vertices()[*it]->get_data().get_id();
+			}
+			request.stream->complete(request.sequence, out.str());
+		}
+	}
+};
@@ -0,0 +1,88 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Pula wątków wykonujących zadania z kolejki FIFO.
+/// </summary>
+class WorkerPool
+{
+private:
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable available;
+	bool stopping = false;
+
+public:
+	/// <summary>
+	/// Konstruktor uruchamiający wątki
+	/// </summary>
+	/// <param name="threads">Liczba wątków (0 - liczba rdzeni)</param>
+	explicit WorkerPool(unsigned int threads = 0) {
+		if (threads == 0) {
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		for (unsigned int i = 0; i < threads; ++i) {
+			workers.emplace_back([this] { run(); });
+		}
+	}
+	/// <summary>
+	/// Destruktor - wykonuje pozostałe zadania i zatrzymuje wątki
+	/// </summary>
+	~WorkerPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		available.notify_all();
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+public:
+	/// <summary>
+	/// Funkcja dodająca zadanie do kolejki
+	/// </summary>
+	/// <param name="task">Zadanie</param>
+	void post(std::function<void()> task) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			tasks.push_back(std::move(task));
+		}
+		available.notify_one();
+	}
+	/// <summary>
+	/// Liczba wątków puli
+	/// </summary>
+	std::size_t size() const { return workers.size(); }
+
+private:
+	void run() {
+		while (true) {
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				available.wait(lock, [this] { return stopping || !tasks.empty(); });
+				if (tasks.empty()) {
+					return;
+				}
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+			task();
+		}
+	}
+};
@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LineSocket.h"
+#include "QueryServer.h"
+#include "../ZTMGraphLoader.h"
+
+/// <summary>
+/// Generator obciążenia serwera zapytań: w jednym procesie z serwerem lub (--socket) przez gniazdo uniksowe
+/// uruchomionego osobno programu server, wtedy pomiar obejmuje też protokół i przesyłanie.
+/// Klienci wysyłają zapytania w otwartej pętli (ze stałą częstotliwością, niezależnie od czasu odpowiedzi),
+/// więc opóźnienia obejmują również czas oczekiwania w kolejce przy przeciążeniu.
+/// Źródła zapytań są skośne: część zapytań startuje z niewielkiego zbioru węzłów o największym stopniu.
+/// Część zapytań (named_share) podaje nazwę algorytmu; takie zapytania podlegają terminowi serwera (--timeout-ms).
+/// </summary>
+struct LoadConfig {
+	double rate = 2000.0;
+	double seconds = 5.0;
+	unsigned int clients = 4;
+	double hub_share = 0.5;
+	std::size_t hub_count = 16;
+	double named_share = 0.0;
+	std::string socket_path;
+};
+
+/// <summary>
+/// Algorytmy zapytań z nazwą, wybierane po kolei
+/// </summary>
+const std::array<const char*, 3> NAMED_ALGORITHMS = { "dijkstra", "astar", "bellmanford" };
+
+/// <summary>
+/// Rodzaje odpowiedzi serwera
+/// </summary>
+enum Reply { REPLY_OK, REPLY_NOPATH, REPLY_TIMEOUT, REPLY_ERROR, REPLY_KINDS };
+
+Reply reply_kind(const std::string& response)
+{
+	if (response.compare(0, 2, "OK") == 0) return REPLY_OK;
+	if (response.compare(0, 6, "NOPATH") == 0) return REPLY_NOPATH;
+	if (response.compare(0, 7, "TIMEOUT") == 0) return REPLY_TIMEOUT;
+	return REPLY_ERROR;
+}
+
+void usage()
+{
+	std::cerr << "usage: loadgen <stations> <routes> [--rate QPS] [--seconds S] [--clients N] [--hub-share P] [--named-share P]" << std::endl
+		<< "                [--socket PATH | --threads N --batch N --window-us N --timeout-ms N]" << std::endl
+		<< "with --socket the server options are given to the server program" << std::endl;
+}
+
+double percentile(const std::vector<double>& sorted, const double p)
+{
+	if (sorted.empty()) {
+		return 0.0;
+	}
+	const std::size_t index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+	return sorted[std::min(index, sorted.size() - 1)];
+}
+
+/// <summary>
+/// Funkcja wypisująca percentyle opóźnień
+/// </summary>
+void print_latency(const std::string& label, std::vector<double> latencies)
+{
+	std::sort(latencies.begin(), latencies.end());
+	std::cout << label << "p50 " << percentile(latencies, 0.50)
+		<< "  p90 " << percentile(latencies, 0.90)
+		<< "  p99 " << percentile(latencies, 0.99)
+		<< "  p99.9 " << percentile(latencies, 0.999)
+		<< "  max " << (latencies.empty() ? 0.0 : latencies.back())
+		<< "  (" << latencies.size() << " queries)" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3) {
+		usage();
+		return 1;
+	}
+	try {
+		ServerConfig server_config;
+		LoadConfig load;
+		bool server_options = false;
+		for (int i = 3; i + 1 < argc; i += 2) {
+			const std::string option = argv[i];
+			const std::string value = argv[i + 1];
+			if (option == "--rate") load.rate = std::stod(value);
+			else if (option == "--seconds") load.seconds = std::stod(value);
+			else if (option == "--clients") load.clients = std::max(1u, static_cast<unsigned int>(std::stoul(value)));
+			else if (option == "--hub-share") load.hub_share = std::stod(value);
+			else if (option == "--named-share") load.named_share = std::stod(value);
+			else if (option == "--socket") load.socket_path = value;
+			else if (option == "--threads" || option == "--batch" || option == "--window-us" || option == "--timeout-ms") {
+				server_options = true;
+				if (option == "--threads") server_config.threads = static_cast<unsigned int>(std::stoul(value));
+				else if (option == "--batch") server_config.max_batch = std::stoul(value);
+				else if (option == "--window-us") server_config.batch_window = std::chrono::microseconds(std::stoul(value));
+				else server_config.query_timeout = std::chrono::milliseconds(std::stoul(value));
+			}
+			else {
+				usage();
+				return 1;
+			}
+		}
+		if (!load.socket_path.empty() && server_options) {
+			usage();
+			return 1;
+		}
+#if !defined(__unix__) && !defined(__APPLE__)
+		if (!load.socket_path.empty()) {
+			std::cerr << "unix sockets are not supported on this platform" << std::endl;
+			return 1;
+		}
+#endif
+
+		const auto graph = load_graph(argv[1], argv[2]);
+		const auto& vertices = graph.get_vertices();
+		if (vertices.empty()) {
+			throw std::runtime_error("graph is empty");
+		}
+		std::vector<VertexIndex> hubs(vertices.size());
+		for (VertexIndex v = 0; v < hubs.size(); ++v) {
+			hubs[v] = v;
+		}
+		const auto& adjacency = graph.get_adjacency();
+		std::sort(hubs.begin(), hubs.end(), [&](const VertexIndex a, const VertexIndex b) {
+			return adjacency.degree(a) > adjacency.degree(b);
+		});
+		hubs.resize(std::min(load.hub_count, hubs.size()));
+
+		using Clock = std::chrono::steady_clock;
+		const std::size_t per_client = static_cast<std::size_t>(load.rate * load.seconds / load.clients);
+		const auto interval = std::chrono::duration<double>(load.clients / load.rate);
+
+		std::vector<std::vector<Clock::time_point>> sent(load.clients, std::vector<Clock::time_point>(per_client));
+		std::vector<std::vector<double>> latencies(load.clients, std::vector<double>(per_client, 0.0));
+		std::vector<std::vector<char>> named(load.clients, std::vector<char>(per_client, 0));
+		std::vector<std::array<std::uint64_t, REPLY_KINDS>> replies(load.clients, std::array<std::uint64_t, REPLY_KINDS>{});
+		std::vector<std::size_t> answered(load.clients, 0);
+
+		Clock::time_point started;
+		Clock::time_point finished;
+		ServerStats stats;
+		{
+			const auto server = load.socket_path.empty() ? std::make_unique<QueryServer>(graph, server_config) : nullptr;
+			std::vector<std::thread> clients;
+			started = Clock::now();
+			for (unsigned int c = 0; c < load.clients; ++c) {
+				clients.emplace_back([&, c] {
+					std::mt19937 random(12345 + c);
+					std::uniform_int_distribution<std::size_t> any(0, vertices.size() - 1);
+					std::uniform_int_distribution<std::size_t> hub(0, hubs.size() - 1);
+					std::bernoulli_distribution from_hub(load.hub_share);
+					std::bernoulli_distribution with_name(load.named_share);
+					std::size_t named_count = 0;
+
+					const auto on_reply = [&, c](const std::uint64_t sequence, const std::string& response) {
+						latencies[c][sequence] = std::chrono::duration<double, std::milli>(Clock::now() - sent[c][sequence]).count();
+						++replies[c][reply_kind(response)];
+						++answered[c];
+					};
+					// Wysyła zapytania zgodnie z harmonogramem; send zwraca false, gdy połączenie zostało zamknięte.
+					const auto generate = [&](const std::function<bool(const std::string&)>& send) {
+						const auto begin = Clock::now();
+						for (std::size_t i = 0; i < per_client; ++i) {
+							const auto due = begin + std::chrono::duration_cast<Clock::duration>(interval * static_cast<double>(i));
+							std::this_thread::sleep_until(due);
+							const VertexIndex from = from_hub(random) ? hubs[hub(random)] : static_cast<VertexIndex>(any(random));
+							const VertexIndex to = static_cast<VertexIndex>(any(random));
+							std::string query;
+							if (with_name(random)) {
+								named[c][i] = 1;
+								query = std::string(NAMED_ALGORITHMS[named_count++ % NAMED_ALGORITHMS.size()]) + " ";
+							}
+							query += std::to_string(vertices[from]->get_data().get_id()) + " "
+								+ std::to_string(vertices[to]->get_data().get_id());
+							// Opóźnienie liczone od planowanego czasu wysłania (bez efektu koordynowanego pomijania).
+							sent[c][i] = due;
+							if (!send(query)) {
+								return;
+							}
+						}
+					};
+
+					if (server) {
+						ResponseStream stream(on_reply);
+						generate([&](const std::string& query) {
+							server->submit(stream, query);
+							return true;
+						});
+						stream.wait_until_drained();
+						return;
+					}
+#if defined(__unix__) || defined(__APPLE__)
+					const int fd = connect_unix(load.socket_path);
+					// Odpowiedzi przychodzą w kolejności zapytań, więc numer linii jest numerem zapytania.
+					std::thread receiver([&, fd] {
+						LineReader reader(fd);
+						std::string line;
+						for (std::uint64_t sequence = 0; sequence < per_client && reader.next(line); ++sequence) {
+							on_reply(sequence, line);
+						}
+					});
+					generate([fd](const std::string& query) { return send_line(fd, query + '\n'); });
+					::shutdown(fd, SHUT_WR);
+					receiver.join();
+					::close(fd);
+#endif
+				});
+			}
+			for (auto& client : clients) {
+				client.join();
+			}
+			finished = Clock::now();
+			if (server) {
+				stats = server->get_stats();
+			}
+		}
+
+		std::vector<double> all;
+		std::vector<double> named_latencies;
+		std::vector<double> unnamed_latencies;
+		std::array<std::uint64_t, REPLY_KINDS> totals{};
+		std::size_t sent_count = 0;
+		for (unsigned int c = 0; c < load.clients; ++c) {
+			for (std::size_t i = 0; i < answered[c]; ++i) {
+				all.push_back(latencies[c][i]);
+				(named[c][i] ? named_latencies : unnamed_latencies).push_back(latencies[c][i]);
+			}
+			for (int kind = 0; kind < REPLY_KINDS; ++kind) {
+				totals[kind] += replies[c][kind];
+			}
+			sent_count += per_client;
+		}
+		const double elapsed = std::chrono::duration<double>(finished - started).count();
+
+		std::cout << std::fixed << std::setprecision(3)
+			<< "queries:     " << sent_count << " (" << all.size() << " answered)" << std::endl
+			<< "replies:     OK " << totals[REPLY_OK] << ", NOPATH " << totals[REPLY_NOPATH]
+			<< ", TIMEOUT " << totals[REPLY_TIMEOUT] << ", ERROR " << totals[REPLY_ERROR] << std::endl
+			<< "target rate: " << load.rate << " q/s" << std::endl
+			<< "throughput:  " << static_cast<double>(all.size()) / elapsed << " q/s" << std::endl;
+		if (load.socket_path.empty()) {
+			std::cout << "batches:     " << stats.batches << ", searches: " << stats.searches
+				<< " (" << (stats.searches == 0 ? 0.0 : static_cast<double>(stats.queries) / stats.searches) << " queries/search)" << std::endl;
+		}
+		print_latency("latency ms:  ", all);
+		if (!named_latencies.empty()) {
+			print_latency("  unnamed:   ", unnamed_latencies);
+			print_latency("  named:     ", named_latencies);
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "QueryServer.h"
+#include "../ZTMGraphLoader.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+
+#include <atomic>
+#include <csignal>
+#include <mutex>
+#include <unordered_set>
+
+#include "LineSocket.h"
+#include "WorkerPool.h"
+
+/// <summary>
+/// Flaga zatrzymania serwera ustawiana przez SIGINT i SIGTERM
+/// </summary>
+volatile std::sig_atomic_t stop_requested = 0;
+
+void request_stop(int)
+{
+	stop_requested = 1;
+}
+
+/// <summary>
+/// Zbiór otwartych połączeń. Przy zatrzymaniu serwera kończy odczyt z nich wszystkich,
+/// aby wątki obsługi wysłały zaległe odpowiedzi i zakończyły się.
+/// </summary>
+class ConnectionSet
+{
+private:
+	std::mutex mutex;
+	std::unordered_set<int> fds;
+
+public:
+	/// <summary>
+	/// Funkcja dodająca połączenie, jeśli nie przekroczono limitu
+	/// </summary>
+	/// <param name="fd">Deskryptor połączenia</param>
+	/// <param name="limit">Maksymalna liczba jednoczesnych połączeń</param>
+	/// <returns>true, jeśli połączenie zostało przyjęte</returns>
+	bool try_add(const int fd, const std::size_t limit) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (fds.size() >= limit) {
+			return false;
+		}
+		fds.insert(fd);
+		return true;
+	}
+	/// <summary>
+	/// Funkcja usuwająca i zamykająca połączenie
+	/// </summary>
+	void close(const int fd) {
+		std::lock_guard<std::mutex> lock(mutex);
+		fds.erase(fd);
+		::close(fd);
+	}
+	/// <summary>
+	/// Funkcja kończąca odczyt ze wszystkich połączeń (odpowiedzi nadal mogą być wysyłane)
+	/// </summary>
+	void shutdown_reads() {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (const int fd : fds) {
+			::shutdown(fd, SHUT_RD);
+		}
+	}
+};
+
+/// <summary>
+/// Funkcja odrzucająca połączenie ponad limit. Przed zamknięciem odczytywane są już odebrane dane,
+/// bo zamknięcie gniazda z nieodczytanymi danymi wysyła RST, przez który klient traci odpowiedź.
+/// </summary>
+void reject(const int fd)
+{
+	send_line(fd, "ERROR too many connections\n");
+	::shutdown(fd, SHUT_WR);
+	char chunk[4096];
+	while (::recv(fd, chunk, sizeof(chunk), MSG_DONTWAIT) > 0) {}
+	::close(fd);
+}
+
+/// <summary>
+/// Funkcja obsługująca jedno połączenie: czyta linie zapytań z gniazda i odsyła odpowiedzi w kolejności zapytań.
+/// Po zamknięciu połączenia przez klienta nowe zapytania nie są przyjmowane, a pozostałe odpowiedzi są pomijane.
+/// </summary>
+void serve_connection(QueryServer& server, const int fd)
+{
+	std::atomic<bool> closed{ false };
+	ResponseStream stream([fd, &closed](std::uint64_t, const std::string& response) {
+		if (!closed && !send_line(fd, response + '\n')) {
+			closed = true;
+		}
+	});
+
+	LineReader reader(fd);
+	for (std::string line; !closed && reader.next(line);) {
+		if (!line.empty()) {
+			server.submit(stream, line);
+		}
+	}
+	stream.wait_until_drained();
+}
+
+/// <summary>
+/// Funkcja nasłuchująca na gnieździe uniksowym. Połączenia obsługuje pula max_connections wątków;
+/// nadmiarowe połączenia dostają odpowiedź "ERROR too many connections" i są zamykane.
+/// SIGINT lub SIGTERM kończy nasłuchiwanie, po czym funkcja czeka na obsłużenie otwartych połączeń.
+/// </summary>
+void serve_socket(QueryServer& server, const std::string& path, const std::size_t max_connections)
+{
+	std::signal(SIGPIPE, SIG_IGN);
+	std::signal(SIGINT, request_stop);
+	std::signal(SIGTERM, request_stop);
+
+	const int listener = listen_unix(path);
+	std::cerr << "listening on " << path << std::endl;
+
+	ConnectionSet connections;
+	{
+		WorkerPool pool(static_cast<unsigned int>(max_connections));
+		while (!stop_requested) {
+			// Oczekiwanie z limitem czasu, bo sygnał może trafić do innego wątku i nie przerwać poll().
+			pollfd entry{ listener, POLLIN, 0 };
+			if (::poll(&entry, 1, 200) <= 0) {
+				continue;
+			}
+			const int fd = ::accept(listener, nullptr, nullptr);
+			if (fd < 0) {
+				continue;
+			}
+			if (!connections.try_add(fd, max_connections)) {
+				reject(fd);
+				continue;
+			}
+			pool.post([&server, &connections, fd] {
+				serve_connection(server, fd);
+				connections.close(fd);
+			});
+		}
+		connections.shutdown_reads();
+	}
+	::close(listener);
+	::unlink(path.c_str());
+}
+#endif
+
+void usage()
+{
+	std::cerr << "usage: server <stations> <routes> [--socket PATH] [--connections N] [--threads N] [--batch N] [--window-us N] [--timeout-ms N]" << std::endl
+		<< "query:  [dijkstra|astar|bellmanford] <from_id> <to_id>" << std::endl
+		<< "reply:  OK <cost> <id>... | NOPATH | TIMEOUT [<cost> <id>...] | ERROR <message>" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3) {
+		usage();
+		return 1;
+	}
+	try {
+		ServerConfig config;
+		std::string socket_path;
+		std::size_t max_connections = 64;
+		for (int i = 3; i < argc; ++i) {
+			const std::string option = argv[i];
+			if (i + 1 >= argc) {
+				usage();
+				return 1;
+			}
+			const std::string value = argv[++i];
+			if (option == "--socket") {
+				socket_path = value;
+			}
+			else if (option == "--connections") {
+				max_connections = std::max<std::size_t>(1, std::stoul(value));
+			}
+			else if (option == "--threads") {
+				config.threads = static_cast<unsigned int>(std::stoul(value));
+			}
+			else if (option == "--batch") {
+				config.max_batch = std::stoul(value);
+			}
+			else if (option == "--window-us") {
+				config.batch_window = std::chrono::microseconds(std::stoul(value));
+			}
+			else if (option == "--timeout-ms") {
+				config.query_timeout = std::chrono::milliseconds(std::stoul(value));
+			}
+			else {
+				usage();
+				return 1;
+			}
+		}
+
+		const auto graph = load_graph(argv[1], argv[2]);
+		QueryServer server(graph, config);
+
+		if (socket_path.empty()) {
+			std::ios::sync_with_stdio(false);
+			server.serve(std::cin, std::cout);
+		}
+		else {
+#if defined(__unix__) || defined(__APPLE__)
+			serve_socket(server, socket_path, max_connections);
+#else
+			std::cerr << "unix sockets are not supported on this platform" << std::endl;
+			return 1;
+#endif
+		}
+
+		const ServerStats stats = server.get_stats();
+		std::cerr << "queries: " << stats.queries << ", batches: " << stats.batches
+			<< ", searches: " << stats.searches << ", timeouts: " << stats.timeouts << std::endl;
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	catch (...) {
+		std::cerr << "non c++ exception handled" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,97 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "Simd.h"
+
+namespace simd {
+#if defined(SIMD_X86_64)
+	/// <summary>
+	/// Porównanie bloku a z blokiem b obróconym o Rotation; dla równych etykiet aktualizuje minimum sumy odległości.
+	/// </summary>
+	template <int Rotation>
+	SIMD_TARGET_AVX2 inline __m256d intersect_rotation(
+		const __m128i a, const __m256d a_dist,
+		const __m128i b, const __m256d b_dist,
+		const __m256d best
+	) {
+		const __m256d inf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+		const __m128i equal = _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, Rotation));
+		const __m256d mask = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(equal));
+		const __m256d sum = _mm256_add_pd(a_dist, _mm256_permute4x64_pd(b_dist, Rotation));
+		return _mm256_min_pd(best, _mm256_blendv_pd(inf, sum, mask));
+	}
+
+	SIMD_TARGET_AVX2 inline double min_plus_intersection_avx2(
+		const std::uint32_t* ha, const double* da, const std::size_t na,
+		const std::uint32_t* hb, const double* db, const std::size_t nb
+	) {
+		__m256d best = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+		std::size_t i = 0;
+		std::size_t j = 0;
+		while (i < na && j < nb) {
+			const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ha + i));
+			const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hb + j));
+			const __m256d a_dist = _mm256_loadu_pd(da + i);
+			const __m256d b_dist = _mm256_loadu_pd(db + j);
+			best = intersect_rotation<_MM_SHUFFLE(3, 2, 1, 0)>(a, a_dist, b, b_dist, best);
+			best = intersect_rotation<_MM_SHUFFLE(0, 3, 2, 1)>(a, a_dist, b, b_dist, best);
+			best = intersect_rotation<_MM_SHUFFLE(1, 0, 3, 2)>(a, a_dist, b, b_dist, best);
+			best = intersect_rotation<_MM_SHUFFLE(2, 1, 0, 3)>(a, a_dist, b, b_dist, best);
+
+			const std::uint32_t a_last = ha[i + 3];
+			const std::uint32_t b_last = hb[j + 3];
+			i += a_last <= b_last ? 4 : 0;
+			j += b_last <= a_last ? 4 : 0;
+		}
+		const __m128d half = _mm_min_pd(_mm256_castpd256_pd128(best), _mm256_extractf128_pd(best, 1));
+		return _mm_cvtsd_f64(_mm_min_sd(half, _mm_unpackhi_pd(half, half)));
+	}
+#endif
+
+	/// <summary>
+	/// Funkcja wyznaczająca min(da[i] + db[j]) po wszystkich parach, dla których ha[i] == hb[j]
+	/// (przecięcie dwóch posortowanych rosnąco list etykiet, np. etykiet hubów).
+	/// Obie listy muszą mieć długość podzielną przez 4 i być dopełnione wartownikami, które nie występują
+	/// w drugiej liście i są nie mniejsze od wszystkich prawdziwych elementów (odległość wartownika: +inf).
+	/// Wariant AVX2 porównuje bloki 4x4 (cztery rotacje bloku b) i wybiera minimum maskowaniem, bez rozgałęzień
+	/// wewnątrz bloku; wariant skalarny to zwykłe scalanie.
+	/// </summary>
+	/// <param name="ha">Posortowane etykiety pierwszej listy</param>
+	/// <param name="da">Odległości pierwszej listy</param>
+	/// <param name="na">Długość pierwszej listy (z dopełnieniem)</param>
+	/// <param name="hb">Posortowane etykiety drugiej listy</param>
+	/// <param name="db">Odległości drugiej listy</param>
+	/// <param name="nb">Długość drugiej listy (z dopełnieniem)</param>
+	/// <returns>Najmniejsza suma odległości, lub +inf jeśli listy są rozłączne</returns>
+	inline double min_plus_intersection(
+		const std::uint32_t* ha, const double* da, const std::size_t na,
+		const std::uint32_t* hb, const double* db, const std::size_t nb
+	) {
+#if defined(SIMD_X86_64)
+		if (cpu_supports_avx2()) {
+			return min_plus_intersection_avx2(ha, da, na, hb, db, nb);
+		}
+#endif
+		double best = std::numeric_limits<double>::infinity();
+		std::size_t i = 0;
+		std::size_t j = 0;
+		while (i < na && j < nb) {
+			if (ha[i] == hb[j]) {
+				const double sum = da[i] + db[j];
+				best = sum < best ? sum : best;
+				++i;
+				++j;
+			}
+			else if (ha[i] < hb[j]) {
+				++i;
+			}
+			else {
+				++j;
+			}
+		}
+		return best;
+	}
+}
@@ -0,0 +1,136 @@
+﻿#pragma once
+
+#include <cstddef>
+
+#include "Simd.h"
+#include "../graph/Adjacency.h"
+
+namespace simd {
+	namespace detail {
+		inline bool relax_scalar(
+			const VertexIndex u,
+			const VertexIndex* targets,
+			const double* weights,
+			std::size_t i,
+			const std::size_t count,
+			double* dist,
+			VertexIndex* previous
+		) {
+			bool changed = false;
+			const double du = dist[u];
+			for (; i < count; ++i) {
+				const double candidate = du + weights[i];
+				if (candidate < dist[targets[i]]) {
+					dist[targets[i]] = candidate;
+					previous[targets[i]] = u;
+					changed = true;
+				}
+			}
+			return changed;
+		}
+
+#if defined(SIMD_X86_64)
+		inline bool commit_lanes(
+			const VertexIndex u,
+			const VertexIndex* targets,
+			const double* candidates,
+			int mask,
+			double* dist,
+			VertexIndex* previous
+		) {
+			bool changed = false;
+			for (int lane = 0; mask != 0; ++lane, mask >>= 1) {
+				// Ponowne porównanie jest potrzebne, gdy ten sam wierzchołek występuje w kilku torach.
+				if ((mask & 1) && candidates[lane] < dist[targets[lane]]) {
+					dist[targets[lane]] = candidates[lane];
+					previous[targets[lane]] = u;
+					changed = true;
+				}
+			}
+			return changed;
+		}
+
+		SIMD_TARGET_AVX2 inline std::size_t relax_avx2(
+			const VertexIndex u,
+			const VertexIndex* targets,
+			const double* weights,
+			const std::size_t count,
+			double* dist,
+			VertexIndex* previous,
+			bool& changed
+		) {
+			const __m256d du = _mm256_set1_pd(dist[u]);
+			alignas(32) double candidates[4];
+			std::size_t i = 0;
+			for (; i + 4 <= count; i += 4) {
+				const __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(targets + i));
+				const __m256d candidate = _mm256_add_pd(du, _mm256_loadu_pd(weights + i));
+				const __m256d current = gather_pd(dist, idx);
+				const int mask = _mm256_movemask_pd(_mm256_cmp_pd(candidate, current, _CMP_LT_OQ));
+				if (mask != 0) {
+					_mm256_store_pd(candidates, candidate);
+					changed |= commit_lanes(u, targets + i, candidates, mask, dist, previous);
+				}
+			}
+			return i;
+		}
+
+		inline std::size_t relax_sse2(
+			const VertexIndex u,
+			const VertexIndex* targets,
+			const double* weights,
+			const std::size_t count,
+			double* dist,
+			VertexIndex* previous,
+			bool& changed
+		) {
+			const __m128d du = _mm_set1_pd(dist[u]);
+			alignas(16) double candidates[2];
+			std::size_t i = 0;
+			for (; i + 2 <= count; i += 2) {
+				const __m128d candidate = _mm_add_pd(du, _mm_loadu_pd(weights + i));
+				const __m128d current = _mm_set_pd(dist[targets[i + 1]], dist[targets[i]]);
+				const int mask = _mm_movemask_pd(_mm_cmplt_pd(candidate, current));
+				if (mask != 0) {
+					_mm_store_pd(candidates, candidate);
+					changed |= commit_lanes(u, targets + i, candidates, mask, dist, previous);
+				}
+			}
+			return i;
+		}
+#endif
+	}
+
+	/// <summary>
+	/// Funkcja relaksująca wszystkie krawędzie wychodzące z wierzchołka u.
+	/// Sumy dist[u] + weights[e] oraz porównania z dist[targets[e]] liczone są wektorowo,
+	/// a zapis (dist, previous) wykonywany jest skalarnie tylko dla krawędzi, które poprawiają odległość.
+	/// </summary>
+	/// <param name="u">Wierzchołek, którego krawędzie są relaksowane</param>
+	/// <param name="targets">Wierzchołki docelowe krawędzi (ciągły zakres)</param>
+	/// <param name="weights">Wagi krawędzi (ciągły zakres)</param>
+	/// <param name="count">Liczba krawędzi</param>
+	/// <param name="dist">Tablica odległości</param>
+	/// <param name="previous">Tablica poprzedników</param>
+	/// <returns>true, jeśli którakolwiek odległość została poprawiona</returns>
+	inline bool relax_edges(
+		const VertexIndex u,
+		const VertexIndex* targets,
+		const double* weights,
+		const std::size_t count,
+		double* dist,
+		VertexIndex* previous
+	) {
+		bool changed = false;
+		std::size_t i = 0;
+#if defined(SIMD_X86_64)
+		if (simd::cpu_supports_avx2()) {
+			i = detail::relax_avx2(u, targets, weights, count, dist, previous, changed);
+		}
+		else {
+			i = detail::relax_sse2(u, targets, weights, count, dist, previous, changed);
+		}
+#endif
+		return detail::relax_scalar(u, targets, weights, i, count, dist, previous) || changed;
+	}
+}
@@ -0,0 +1,66 @@
+﻿#pragma once
+
+/// <summary>
+/// Wspólne definicje dla jąder wektorowych (SSE2/AVX2).
+/// SSE2 jest częścią bazowego zestawu instrukcji x86-64, więc jest używane bezwarunkowo.
+/// AVX2 wybierane jest w czasie działania programu, jeśli procesor je udostępnia,
+/// dlatego funkcje AVX2 oznaczone są atrybutem SIMD_TARGET_AVX2 zamiast wymagać flagi kompilatora.
+/// Na innych architekturach wszystkie jądra korzystają z kodu skalarnego.
+/// </summary>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_X86_64 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(SIMD_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMD_TARGET_AVX2
+#endif
+
+namespace simd {
+	/// <summary>
+	/// Funkcja sprawdzająca, czy procesor (i system operacyjny) obsługuje instrukcje AVX2.
+	/// Wynik jest wyznaczany raz i zapamiętywany.
+	/// </summary>
+	/// <returns>true, jeśli można wywoływać jądra AVX2.</returns>
+	inline bool cpu_supports_avx2() {
+#if defined(SIMD_X86_64) && (defined(__GNUC__) || defined(__clang__))
+		static const bool supported = __builtin_cpu_supports("avx2");
+		return supported;
+#elif defined(SIMD_X86_64) && defined(_MSC_VER)
+		static const bool supported = [] {
+			int info[4] = {};
+			__cpuid(info, 1);
+			const bool osxsave = (info[2] & (1 << 27)) != 0;
+			const bool avx = (info[2] & (1 << 28)) != 0;
+			if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+				return false;
+			}
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+		}();
+		return supported;
+#else
+		return false;
+#endif
+	}
+
+#if defined(SIMD_X86_64)
+	/// <summary>
+	/// Funkcja pobierająca cztery wartości double spod indeksów 32-bitowych (AVX2 gather).
+	/// Wariant z maską i zerowym źródłem nie pozostawia niezainicjalizowanych torów.
+	/// </summary>
+	/// <param name="base">Tablica źródłowa</param>
+	/// <param name="indices">Cztery indeksy</param>
+	/// <returns>Pobrane wartości</returns>
+	SIMD_TARGET_AVX2 inline __m256d gather_pd(const double* base, const __m128i indices) {
+		const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+		return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, indices, all, 8);
+	}
+#endif
+}
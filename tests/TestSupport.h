@@ -0,0 +1,140 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../algorithm/Algorithm.h"
+#include "../algorithm/SearchKernel.h"
+#include "../ZTMGraphLoader.h"
+
+/// <summary>
+/// Para plików opisujących sieć (przystanki i trasy).
+/// </summary>
+struct TestNetwork {
+	std::string stations;
+	std::string routes;
+};
+
+/// <summary>
+/// Funkcja zwracająca sieci z katalogu resources, na których wykonywane są testy.
+/// </summary>
+/// <param name="directory">Katalog z plikami sieci</param>
+/// <returns>Pary plików przystanków i tras</returns>
+inline std::vector<TestNetwork> test_networks(const std::string& directory) {
+	return {
+		{ directory + "/stations.txt", directory + "/routes.txt" },
+		{ directory + "/stations2.txt", directory + "/routes2.txt" },
+	};
+}
+
+/// <summary>
+/// Zbiór wyników sprawdzeń jednego programu testowego.
+/// Każdy test jest osobnym programem (argument: katalog resources, domyślnie "resources"),
+/// który wypisuje nieudane sprawdzenia i zwraca 1, jeśli którekolwiek się nie powiodło.
+/// </summary>
+class TestReport
+{
+private:
+	std::size_t checks = 0;
+	std::size_t failures = 0;
+
+public:
+	/// <summary>
+	/// Funkcja rejestrująca wynik sprawdzenia
+	/// </summary>
+	/// <param name="condition">Wynik sprawdzenia</param>
+	/// <param name="what">Opis sprawdzenia wypisywany przy błędzie</param>
+	/// <returns>condition</returns>
+	bool check(const bool condition, const std::string& what) {
+		++checks;
+		if (!condition) {
+			++failures;
+			std::cerr << "FAILED: " << what << std::endl;
+		}
+		return condition;
+	}
+	/// <summary>
+	/// Funkcja wypisująca podsumowanie
+	/// </summary>
+	/// <param name="name">Nazwa testu</param>
+	/// <returns>Kod wyjścia programu: 0 - sukces, 1 - błąd</returns>
+	int finish(const std::string& name) const {
+		std::cout << name << ": " << checks - failures << "/" << checks << " checks passed" << std::endl;
+		return failures == 0 ? 0 : 1;
+	}
+};
+
+/// <summary>
+/// Funkcja wyznaczająca wzorcowe odległości ze źródła jądrem Dijkstry.
+/// </summary>
+/// <param name="graph">Graf</param>
+/// <param name="source">Indeks źródła</param>
+/// <returns>Odległości do wszystkich wierzchołków (nieskończoność dla nieosiągalnych)</returns>
+inline std::vector<double> reference_distances(const Graph<Station>& graph, const VertexIndex source) {
+	DijkstraKernel<double, policy::ExhaustAll> kernel;
+	kernel.run(graph.get_adjacency(), source, NO_VERTEX, policy::NoHeuristic());
+	return kernel.get_distances();
+}
+
+/// <summary>
+/// Funkcja porównująca koszty z tolerancją błędu zaokrągleń sumowania w innej kolejności.
+/// </summary>
+inline bool same_cost(const double actual, const double expected) {
+	if (actual == expected) {
+		return true;
+	}
+	return std::abs(actual - expected) <= 1e-9 * std::max(1.0, std::abs(expected));
+}
+
+/// <summary>
+/// Funkcja sprawdzająca, czy ciąg wierzchołków jest ścieżką z start do end w grafie o koszcie cost
+/// (dla krawędzi równoległych liczona jest najmniejsza waga).
+/// </summary>
+/// <param name="graph">Graf</param>
+/// <param name="path">Indeksy kolejnych wierzchołków ścieżki</param>
+/// <param name="start">Wierzchołek początkowy</param>
+/// <param name="end">Wierzchołek końcowy</param>
+/// <param name="cost">Oczekiwany koszt ścieżki</param>
+/// <returns>true, jeśli ścieżka jest poprawna</returns>
+inline bool valid_path(
+	const Graph<Station>& graph,
+	const std::vector<VertexIndex>& path,
+	const VertexIndex start,
+	const VertexIndex end,
+	const double cost
+) {
+	if (path.empty() || path.front() != start || path.back() != end) {
+		return false;
+	}
+	const auto& adjacency = graph.get_adjacency();
+	double total = 0.0;
+	for (std::size_t i = 0; i + 1 < path.size(); ++i) {
+		double best = std::numeric_limits<double>::infinity();
+		for (std::size_t e = adjacency.begin(path[i]); e < adjacency.end(path[i]); ++e) {
+			if (adjacency.get_targets()[e] == path[i + 1]) {
+				best = std::min(best, adjacency.get_weights()[e]);
+			}
+		}
+		if (best == std::numeric_limits<double>::infinity()) {
+			return false;
+		}
+		total += best;
+	}
+	return same_cost(total, cost);
+}
+
+/// <summary>
+/// Funkcja zamieniająca ścieżkę wyniku SolveResult na indeksy wierzchołków.
+/// </summary>
+inline std::vector<VertexIndex> path_indices(const Graph<Station>& graph, const SolveResult<Station>::Path& path) {
+	std::vector<VertexIndex> result;
+	for (const auto& vertex : path) {
+		result.push_back(graph.index_of(vertex));
+	}
+	return result;
+}
@@ -0,0 +1,128 @@
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TestSupport.h"
+#include "../algorithm/AStar.h"
+#include "../algorithm/BellmanFord.h"
+#include "../algorithm/CachedAlgorithm.h"
+#include "../algorithm/Dijkstra.h"
+
+/// <summary>
+/// Funkcja porównująca wszystkie zapytania punkt-punkt (dwukrotnie, aby trafiały w pamięć podręczną)
+/// z odległościami wzorcowymi DijkstraKernel dla bieżących wag grafu.
+/// </summary>
+void check_against_reference(
+	TestReport& report,
+	const Graph<Station>& graph,
+	const Algorithm<Station>& cached,
+	const std::string& what
+) {
+	const auto& vertices = graph.get_vertices();
+	for (int pass = 0; pass < 2; ++pass) {
+		for (VertexIndex s = 0; s < vertices.size(); ++s) {
+			const auto expected = reference_distances(graph, s);
+			for (VertexIndex t = 0; t < vertices.size(); ++t) {
+				const auto result = cached.solve(graph, vertices[s], vertices[t]);
+				const std::string query = what + " " + cached.name() + " " + std::to_string(s) + "->" + std::to_string(t);
+				if (expected[t] == std::numeric_limits<double>::infinity()) {
+					report.check(!result, query + ": path to an unreachable vertex");
+					continue;
+				}
+				if (!report.check(result.has_value(), query + ": no path")) {
+					continue;
+				}
+				report.check(same_cost(result->get_cost(), expected[t]), query + ": cost differs from Dijkstra");
+				report.check(valid_path(graph, path_indices(graph, result->get_path()), s, t, expected[t]), query + ": invalid path");
+			}
+		}
+	}
+}
+
+/// <summary>
+/// Funkcja porównująca wszystkie zapytania algorytmu z pamięcią podręczną z tym samym algorytmem bez niej
+/// (dla algorytmów, których wynik może się różnić od Dijkstry, np. A* z heurystyką niedopuszczalną).
+/// </summary>
+void check_against_uncached(
+	TestReport& report,
+	const Graph<Station>& graph,
+	const Algorithm<Station>& cached,
+	const Algorithm<Station>& plain,
+	const std::string& what
+) {
+	const auto& vertices = graph.get_vertices();
+	for (int pass = 0; pass < 2; ++pass) {
+		for (const auto& s : vertices) {
+			for (const auto& t : vertices) {
+				const auto expected = plain.solve(graph, s, t);
+				const auto result = cached.solve(graph, s, t);
+				const std::string query = what + " " + cached.name() + " " + std::to_string(graph.index_of(s)) + "->" + std::to_string(graph.index_of(t));
+				if (!report.check(result.has_value() == expected.has_value(), query + ": path existence differs")) {
+					continue;
+				}
+				if (expected) {
+					report.check(same_cost(result->get_cost(), expected->get_cost()), query + ": cost differs from the uncached algorithm");
+				}
+			}
+		}
+	}
+}
+
+/// <summary>
+/// Test pamięci podręcznej zapytań: wyniki z pamięci (także odpowiedzi z drzew najkrótszych ścieżek)
+/// muszą być zgodne z DijkstraKernel przed i po zmianach wag przez Graph::set_weight.
+/// </summary>
+int main(int argc, char** argv)
+{
+	const std::string directory = argc > 1 ? argv[1] : "resources";
+	TestReport report;
+	try {
+		for (const auto& network : test_networks(directory)) {
+			auto graph = load_graph(network.stations, network.routes);
+
+			QueryCacheConfig config;
+			config.hot_source_threshold = 2;
+			config.max_source_states = 2;
+			const auto cache = std::make_shared<QueryCache<Station>>(config);
+			const CachedAlgorithm<Station> dijkstra(std::make_unique<Dijkstra<Station>>(), cache);
+			const CachedAlgorithm<Station> bellman_ford(std::make_unique<BellmanFord<Station>>(), cache);
+			const CachedAlgorithm<Station> astar(std::make_unique<AStar<Station>>(), cache);
+			const AStar<Station> plain_astar;
+
+			const auto run = [&](const std::string& what) {
+				check_against_reference(report, graph, dijkstra, network.stations + " " + what);
+				check_against_reference(report, graph, bellman_ford, network.stations + " " + what);
+				check_against_uncached(report, graph, astar, plain_astar, network.stations + " " + what);
+			};
+
+			run("initial weights");
+			const auto trees_before = cache->tree_stats().insertions;
+			report.check(cache->result_stats().hits > 0, network.stations + ": no result cache hits");
+			report.check(trees_before > 0, network.stations + ": no shortest-path trees were built");
+
+			std::vector<std::pair<EdgeSPtr<Station>, double>> original;
+			std::size_t i = 0;
+			for (const auto& [edge, weight] : graph.get_edges()) {
+				original.emplace_back(edge, weight);
+				if (i++ % 3 == 0) {
+					graph.set_weight(edge, weight * 4.0 + 1.0);
+				}
+				else if (i % 3 == 0) {
+					graph.set_weight(edge, weight / 2.0);
+				}
+			}
+			run("changed weights");
+			report.check(cache->tree_stats().insertions > trees_before, network.stations + ": trees were not rebuilt after set_weight");
+
+			for (const auto& [edge, weight] : original) {
+				graph.set_weight(edge, weight);
+			}
+			run("restored weights");
+		}
+	}
+	catch (const std::exception& e) {
+		report.check(false, std::string("exception: ") + e.what());
+	}
+	return report.finish("cache_test");
+}
@@ -0,0 +1,122 @@
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TestSupport.h"
+#include "../algorithm/CRP.h"
+
+/// <summary>
+/// Funkcja opisująca rozmiary komórek w komunikatach błędów.
+/// </summary>
+std::string describe(const std::vector<std::size_t>& cell_sizes) {
+	std::string result = "{";
+	for (std::size_t i = 0; i < cell_sizes.size(); ++i) {
+		result += (i == 0 ? "" : ",") + std::to_string(cell_sizes[i]);
+	}
+	return result + "}";
+}
+
+/// <summary>
+/// Funkcja sprawdzająca, czy podział jest hierarchiczny (komórka poziomu l leży w jednej komórce poziomu l + 1)
+/// i czy komórki nie przekraczają zadanych rozmiarów - od tego zależy wybór poziomu zapytania.
+/// </summary>
+void check_partition(
+	TestReport& report,
+	const Partition& partition,
+	const std::size_t n,
+	const std::vector<std::size_t>& cell_sizes,
+	const std::string& what
+) {
+	report.check(partition.level_count() == cell_sizes.size(), what + ": wrong number of levels");
+	for (std::size_t l = 0; l < partition.level_count(); ++l) {
+		std::vector<std::size_t> sizes(partition.cell_count(l), 0);
+		std::map<VertexIndex, VertexIndex> parent;
+		for (VertexIndex v = 0; v < n; ++v) {
+			++sizes[partition.cell(l, v)];
+			if (l + 1 < partition.level_count()) {
+				const auto [it, inserted] = parent.emplace(partition.cell(l, v), partition.cell(l + 1, v));
+				report.check(inserted || it->second == partition.cell(l + 1, v),
+					what + ": cell of level " + std::to_string(l) + " is split between cells of the next level");
+			}
+		}
+		for (const std::size_t size : sizes) {
+			report.check(size <= cell_sizes[l], what + ": cell of level " + std::to_string(l) + " is too large");
+		}
+	}
+}
+
+/// <summary>
+/// Funkcja porównująca wszystkie zapytania silnika (koszt i rozpakowaną ścieżkę) z DijkstraKernel.
+/// </summary>
+void check_queries(TestReport& report, const Graph<Station>& graph, const CRP<Station>& crp, const std::string& what) {
+	const auto& vertices = graph.get_vertices();
+	for (VertexIndex s = 0; s < vertices.size(); ++s) {
+		const auto expected = reference_distances(graph, s);
+		for (VertexIndex t = 0; t < vertices.size(); ++t) {
+			const auto result = crp.solve(graph, vertices[s], vertices[t]);
+			const std::string query = what + " " + std::to_string(s) + "->" + std::to_string(t);
+			if (expected[t] == std::numeric_limits<double>::infinity()) {
+				report.check(!result, query + ": path to an unreachable vertex");
+				continue;
+			}
+			if (!report.check(result.has_value(), query + ": no path")) {
+				continue;
+			}
+			report.check(same_cost(result->get_cost(), expected[t]), query + ": cost differs from Dijkstra");
+			report.check(valid_path(graph, path_indices(graph, result->get_path()), s, t, expected[t]), query + ": unpacked path is invalid");
+		}
+	}
+}
+
+/// <summary>
+/// Test routingu na nakładkach (CRP): dla różnej liczby poziomów i rozmiarów komórek zapytania
+/// (przechodzące przez kliki różnych poziomów) i rozpakowane ścieżki muszą być zgodne z DijkstraKernel,
+/// także po zmianie wag i kustomizacji częściowej oraz pełnej.
+/// </summary>
+int main(int argc, char** argv)
+{
+	const std::string directory = argc > 1 ? argv[1] : "resources";
+	const std::vector<std::vector<std::size_t>> configurations = {
+		{ 64 }, { 2 }, { 2, 4 }, { 3, 6, 12 }, { 2, 4, 8, 16 }, { 1, 2, 4 },
+	};
+	TestReport report;
+	try {
+		for (const auto& network : test_networks(directory)) {
+			auto graph = load_graph(network.stations, network.routes);
+			for (const auto& cell_sizes : configurations) {
+				const std::string what = network.stations + " " + describe(cell_sizes);
+				const OverlayRouter router(graph.get_adjacency(), graph.get_localizations(), cell_sizes, 2);
+				check_partition(report, router.get_partition(), graph.get_vertices().size(), cell_sizes, what);
+
+				CRP<Station> crp(graph, cell_sizes, 2);
+				check_queries(report, graph, crp, what);
+
+				// Kustomizacja częściowa: przeliczane są tylko komórki zmienionych krawędzi.
+				std::vector<std::pair<EdgeSPtr<Station>, double>> original;
+				std::vector<EdgeSPtr<Station>> changed;
+				std::size_t i = 0;
+				for (const auto& [edge, weight] : graph.get_edges()) {
+					original.emplace_back(edge, weight);
+					if (i++ % 4 == 0) {
+						graph.set_weight(edge, weight * 3.0 + 2.0);
+						changed.push_back(edge);
+					}
+				}
+				crp.customize(changed);
+				check_queries(report, graph, crp, what + " after partial customization");
+
+				// Kustomizacja pełna: solve() wykrywa zmianę wersji grafu.
+				for (const auto& [edge, weight] : original) {
+					graph.set_weight(edge, weight);
+				}
+				check_queries(report, graph, crp, what + " after full customization");
+				report.check(crp.get_stats().queries > 0, what + ": queries were not counted");
+			}
+		}
+	}
+	catch (const std::exception& e) {
+		report.check(false, std::string("exception: ") + e.what());
+	}
+	return report.finish("crp_test");
+}
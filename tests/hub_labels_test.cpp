@@ -0,0 +1,140 @@
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TestSupport.h"
+#include "../algorithm/HubLabeling.h"
+#include "../labels/HubLabels.h"
+
+/// <summary>
+/// Funkcja porównująca odległości i ścieżki indeksu z DijkstraKernel dla wszystkich par wierzchołków.
+/// </summary>
+void check_labels(TestReport& report, const Graph<Station>& graph, const HubLabels& labels, const std::string& what) {
+	const std::size_t n = graph.get_vertices().size();
+	report.check(labels.vertex_count() == n, what + ": wrong vertex count");
+	for (VertexIndex s = 0; s < n; ++s) {
+		const auto expected = reference_distances(graph, s);
+		for (VertexIndex t = 0; t < n; ++t) {
+			const std::string query = what + " " + std::to_string(s) + "->" + std::to_string(t);
+			const double actual = labels.distance(s, t);
+			if (expected[t] == std::numeric_limits<double>::infinity()) {
+				report.check(actual == expected[t], query + ": distance to an unreachable vertex");
+				if (labels.has_paths()) {
+					report.check(labels.path(s, t).empty(), query + ": path to an unreachable vertex");
+				}
+				continue;
+			}
+			report.check(same_cost(actual, expected[t]), query + ": distance differs from Dijkstra");
+			if (labels.has_paths()) {
+				report.check(valid_path(graph, labels.path(s, t), s, t, expected[t]), query + ": invalid path");
+			}
+		}
+	}
+}
+
+/// <summary>
+/// Funkcja porównująca odpowiedzi algorytmu HubLabeling z DijkstraKernel dla wszystkich par wierzchołków.
+/// </summary>
+void check_algorithm(TestReport& report, const Graph<Station>& graph, const HubLabeling<Station>& algorithm, const std::string& what) {
+	const auto& vertices = graph.get_vertices();
+	for (VertexIndex s = 0; s < vertices.size(); ++s) {
+		const auto expected = reference_distances(graph, s);
+		for (VertexIndex t = 0; t < vertices.size(); ++t) {
+			const auto result = algorithm.solve(graph, vertices[s], vertices[t]);
+			const std::string query = what + " " + std::to_string(s) + "->" + std::to_string(t);
+			if (expected[t] == std::numeric_limits<double>::infinity()) {
+				report.check(!result, query + ": path to an unreachable vertex");
+				continue;
+			}
+			if (!report.check(result.has_value(), query + ": no path")) {
+				continue;
+			}
+			report.check(same_cost(result->get_cost(), expected[t]), query + ": cost differs from Dijkstra");
+			report.check(valid_path(graph, path_indices(graph, result->get_path()), s, t, expected[t]), query + ": invalid path");
+		}
+	}
+}
+
+/// <summary>
+/// Funkcja sprawdzająca, czy wczytanie indeksu zgłasza błąd
+/// </summary>
+bool load_fails(const std::string& data, const Adjacency<double>& adjacency) {
+	std::istringstream in(data);
+	try {
+		HubLabels::load(in, adjacency);
+	}
+	catch (const std::runtime_error&) {
+		return true;
+	}
+	return false;
+}
+
+/// <summary>
+/// Test indeksu etykiet hubów: odległości i ścieżki zbudowanego oraz zapisanego i wczytanego indeksu
+/// muszą być zgodne z DijkstraKernel; wczytanie indeksu innego grafu lub uszkodzonego pliku musi się nie udać.
+/// </summary>
+int main(int argc, char** argv)
+{
+	const std::string directory = argc > 1 ? argv[1] : "resources";
+	TestReport report;
+	try {
+		for (const auto& network : test_networks(directory)) {
+			auto graph = load_graph(network.stations, network.routes);
+			const auto& adjacency = graph.get_adjacency();
+			for (const unsigned int threads : { 1u, 3u }) {
+				for (const bool with_paths : { true, false }) {
+					const std::string what = network.stations + " threads " + std::to_string(threads)
+						+ (with_paths ? " with paths" : " without paths");
+					const HubLabels labels(adjacency, threads, with_paths);
+					report.check(labels.has_paths() == with_paths, what + ": wrong has_paths()");
+					report.check(labels.get_stats().mean_label_size <= static_cast<double>(labels.get_stats().max_label_size),
+						what + ": mean label size exceeds the maximum");
+					check_labels(report, graph, labels, what);
+
+					std::ostringstream out;
+					labels.save(out);
+					std::istringstream in(out.str());
+					const HubLabels loaded = HubLabels::load(in, adjacency);
+					report.check(loaded.has_paths() == with_paths, what + " loaded: wrong has_paths()");
+					report.check(loaded.get_stats().label_entries == labels.get_stats().label_entries, what + " loaded: label entries differ");
+					report.check(loaded.matches(adjacency), what + " loaded: does not match the graph");
+					check_labels(report, graph, loaded, what + " loaded");
+
+					const std::string data = out.str();
+					report.check(load_fails(data.substr(0, data.size() / 2), adjacency), what + ": truncated file was loaded");
+					report.check(load_fails("not a label file", adjacency), what + ": file without header was loaded");
+				}
+			}
+
+			// Indeks zapisany przed zmianą wag nie pasuje do grafu po zmianie.
+			std::ostringstream out;
+			HubLabels(adjacency, 1).save(out);
+			const auto edge = graph.get_edges().begin()->first;
+			const double weight = graph.get_edges().begin()->second;
+			graph.set_weight(edge, weight + 1.0);
+			report.check(load_fails(out.str(), graph.get_adjacency()), network.stations + ": labels of the old weights were loaded");
+			graph.set_weight(edge, weight);
+
+			// Plik indeksu: pierwsze wywołanie buduje i zapisuje, drugie wczytuje; HubLabeling przebudowuje po set_weight.
+			const std::string path = (std::filesystem::temp_directory_path() / "hub_labels_test.bin").string();
+			std::remove(path.c_str());
+			const HubLabels built = load_hub_labels(graph, path, 2);
+			report.check(std::filesystem::exists(path), network.stations + ": label file was not written");
+			HubLabels reloaded = load_hub_labels(graph, path, 2);
+			std::remove(path.c_str());
+			report.check(built.get_stats().build_ms > 0, network.stations + ": labels were not built");
+			report.check(reloaded.get_stats().build_ms == 0, network.stations + ": label file was not reused");
+			HubLabeling<Station> algorithm(graph, std::move(reloaded), 2);
+			check_algorithm(report, graph, algorithm, network.stations + " HubLabeling from file");
+			graph.set_weight(edge, weight * 2.0 + 1.0);
+			check_algorithm(report, graph, algorithm, network.stations + " HubLabeling after set_weight");
+		}
+	}
+	catch (const std::exception& e) {
+		report.check(false, std::string("exception: ") + e.what());
+	}
+	return report.finish("hub_labels_test");
+}
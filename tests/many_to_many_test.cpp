@@ -0,0 +1,103 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TestSupport.h"
+#include "../algorithm/ManyToMany.h"
+
+/// <summary>
+/// Funkcja porównująca macierz kosztów z odległościami DijkstraKernel.
+/// </summary>
+void check_matrix(
+	TestReport& report,
+	const Graph<Station>& graph,
+	const std::vector<VertexSPtr<Station>>& sources,
+	const std::vector<VertexSPtr<Station>>& targets,
+	const CostMatrix<double>& matrix,
+	const std::string& what
+) {
+	if (!report.check(matrix.rows() == sources.size() && matrix.columns() == targets.size(), what + ": wrong matrix size")) {
+		return;
+	}
+	for (std::size_t i = 0; i < sources.size(); ++i) {
+		const auto expected = reference_distances(graph, graph.index_of(sources[i]));
+		for (std::size_t j = 0; j < targets.size(); ++j) {
+			const double cost = expected[graph.index_of(targets[j])];
+			const std::string pair = what + " [" + std::to_string(i) + "," + std::to_string(j) + "]";
+			if (cost == std::numeric_limits<double>::infinity()) {
+				report.check(!matrix.reachable(i, j), pair + ": cost to an unreachable target");
+				continue;
+			}
+			report.check(same_cost(matrix.at(i, j), cost), pair + ": cost differs from Dijkstra");
+		}
+	}
+}
+
+/// <summary>
+/// Test macierzy kosztów wielu do wielu: dla różnych rozmiarów kul wstecz (także 1 wierzchołek, gdy przeszukanie
+/// w przód kończy się dopiero po warunku stopu z promieniami kul) i liczby wątków, na indeksie etykiet hubów
+/// oraz po zmianie wag koszty muszą być zgodne z DijkstraKernel.
+/// </summary>
+int main(int argc, char** argv)
+{
+	const std::string directory = argc > 1 ? argv[1] : "resources";
+	TestReport report;
+	try {
+		for (const auto& network : test_networks(directory)) {
+			auto graph = load_graph(network.stations, network.routes);
+			const auto& vertices = graph.get_vertices();
+			const std::size_t n = vertices.size();
+
+			// Wszystkie pary oraz losowe podzbiory z powtórzeniami (źródło może być też celem).
+			std::vector<std::pair<std::vector<VertexSPtr<Station>>, std::vector<VertexSPtr<Station>>>> cases;
+			cases.emplace_back(vertices, vertices);
+			std::mt19937 random(7);
+			std::uniform_int_distribution<std::size_t> any(0, n - 1);
+			for (const std::size_t size : { std::size_t(1), std::size_t(3), n / 2, n + 5 }) {
+				std::vector<VertexSPtr<Station>> sources;
+				std::vector<VertexSPtr<Station>> targets;
+				for (std::size_t k = 0; k < size; ++k) {
+					sources.push_back(vertices[any(random)]);
+					targets.push_back(vertices[any(random)]);
+				}
+				cases.emplace_back(sources, targets);
+			}
+
+			const auto run_all = [&](const std::string& stage) {
+				for (std::size_t c = 0; c < cases.size(); ++c) {
+					const auto& [sources, targets] = cases[c];
+					const std::string what = network.stations + " " + stage + " case " + std::to_string(c);
+					for (const std::size_t bucket_limit : { std::size_t(1), std::size_t(2), std::size_t(5), n, std::size_t(0) }) {
+						for (const unsigned int threads : { 1u, 3u }) {
+							const ManyToMany<Station> many_to_many(threads, bucket_limit);
+							check_matrix(report, graph, sources, targets, many_to_many.solve(graph, sources, targets),
+								what + " bucket_limit " + std::to_string(bucket_limit) + " threads " + std::to_string(threads));
+						}
+					}
+					const HubLabeling<Station> index(graph, 2);
+					check_matrix(report, graph, sources, targets, ManyToMany<Station>(index, 2).solve(graph, sources, targets),
+						what + " hub labels");
+				}
+			};
+
+			run_all("initial weights");
+			std::size_t i = 0;
+			for (const auto& [edge, weight] : graph.get_edges()) {
+				if (i++ % 3 == 0) {
+					graph.set_weight(edge, weight * 5.0 + 1.0);
+				}
+			}
+			run_all("changed weights");
+
+			const ManyToMany<Station> many_to_many(2);
+			const auto empty = many_to_many.solve(graph, {}, vertices);
+			report.check(empty.rows() == 0 && empty.columns() == n, network.stations + ": wrong size of a matrix without sources");
+			const auto no_targets = many_to_many.solve(graph, vertices, {});
+			report.check(no_targets.rows() == n && no_targets.columns() == 0, network.stations + ": wrong size of a matrix without targets");
+		}
+	}
+	catch (const std::exception& e) {
+		report.check(false, std::string("exception: ") + e.what());
+	}
+	return report.finish("many_to_many_test");
+}